@@ -0,0 +1,29 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Alineación a Línea de Caché
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Constante común para separar datos escritos por hilos distintos
+ *           en líneas de caché diferentes (evitar false sharing) y pausa
+ *           para ciclos de espera activa
+ */
+
+#pragma once
+
+#include <cstddef>
+
+// Tamaño de línea de caché (x86-64). Se fija en 64 en vez de usar
+// std::hardware_destructive_interference_size para no depender del compilador
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * Pausa breve dentro de un ciclo de espera activa (libera recursos del
+ * núcleo para el hilo hermano SMT y evita especulación inútil al salir)
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
@@ -0,0 +1,62 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Reloj de Ciclos (TSC)
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Marcas de tiempo baratas para medir operaciones individuales
+ *           (decenas de ns) sin la llamada a clock_gettime en cada muestra
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "timing.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ============================================================================
+// LECTURA Y CALIBRACIÓN
+// ============================================================================
+
+/**
+ * Contador de ciclos actual: rdtsc en x86 (TSC invariante en CPUs modernas,
+ * la misma frecuencia en todos los núcleos); en otras arquitecturas, ns de
+ * CLOCK_MONOTONIC. Sin serializar: error de unos pocos ciclos por muestra
+ */
+inline uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return now_ns();
+#endif
+}
+
+/**
+ * Ciclos de read_cycles() por nanosegundo, medidos una vez contra
+ * CLOCK_MONOTONIC durante ~20 ms (la primera llamada los paga)
+ */
+inline double cycles_per_ns() {
+    static const double ratio = [] {
+        uint64_t ns_start = now_ns();
+        uint64_t cycles_start = read_cycles();
+        uint64_t ns_end;
+        do {
+            ns_end = now_ns();
+        } while (ns_end - ns_start < 20000000ull);
+        uint64_t cycles_end = read_cycles();
+        double measured = (double)(cycles_end - cycles_start) / (double)(ns_end - ns_start);
+        return measured > 0.0 ? measured : 1.0;
+    }();
+    return ratio;
+}
+
+/**
+ * Convertir una duración en ciclos a ns
+ */
+inline uint64_t cycles_to_ns(uint64_t cycles) {
+    return (uint64_t)((double)cycles / cycles_per_ns() + 0.5);
+}
@@ -0,0 +1,255 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Reclamación de Memoria por Épocas (EBR)
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Permitir que lectores recorran estructuras enlazadas sin locks
+ *           mientras los escritores quitan nodos: la liberación se difiere
+ *           hasta que ningún lector pueda seguir viéndolos
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "cacheline.hpp"
+#include "latency_histogram.hpp"
+#include "thread_index.hpp"
+#include "timing.hpp"
+
+// ============================================================================
+// ESTADÍSTICAS
+// ============================================================================
+
+/**
+ * Resumen de la reclamación (leer cuando los hilos terminaron)
+ */
+struct EbrStats {
+    long retired = 0;             // Objetos entregados a retire()
+    long reclaimed = 0;           // Liberados tras un periodo de gracia
+    long pending = 0;             // Retirados aún sin liberar
+    long peak_pending = 0;        // Máximo de retirados pendientes a la vez
+    std::size_t peak_pending_bytes = 0;
+    long epoch_advances = 0;      // Veces que avanzó la época global
+    LatencyHistogram latency;     // retire() -> liberación, en ns
+};
+
+// ============================================================================
+// CLASE EBRDOMAIN
+// ============================================================================
+
+/**
+ * Dominio de reclamación por épocas (3 épocas, al estilo de Fraser)
+ *
+ * - Hay una época global E. Un lector entra a una sección crítica (enter)
+ *   publicando E en su slot con el bit de activo, y sale (exit) limpiándolo.
+ *   Ambas son escrituras a su propio slot alineado: los lectores no
+ *   comparten ninguna línea escrita entre ellos
+ * - retire(p) guarda p en la lista del hilo con la época actual
+ * - E solo avanza a E+1 cuando todos los hilos activos ya observaron E. Así,
+ *   un objeto retirado en la época e ya no es alcanzable por nadie cuando la
+ *   global llega a e+2 (todo lector que pudo verlo ya salió) y se libera
+ *
+ * Cada hilo usa el slot de su thread_index(); un hilo nuevo que recicla el
+ * índice hereda la lista de retirados del anterior. Un lector nunca espera:
+ * si un hilo se queda dentro de una sección crítica, solo se retrasa la
+ * liberación.
+ */
+class EbrDomain {
+public:
+    static constexpr int MAX_THREADS = MAX_THREAD_INDEX;
+    static constexpr int ADVANCE_EVERY = 64;   // retire() entre intentos de avanzar
+
+private:
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch;
+        uint64_t retire_ns;
+        std::size_t bytes;
+    };
+
+    // Datos privados del hilo dueño (en otra línea que el slot público)
+    struct alignas(CACHE_LINE_SIZE) Local {
+        std::vector<Retired> limbo;
+        std::size_t limbo_head = 0;       // Primer pendiente (la lista va en orden de época)
+        int since_advance = 0;
+        long retired = 0;
+        long reclaimed = 0;
+        LatencyHistogram latency;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint64_t> state{0};   // (época << 1) | 1 si está dentro, 0 si no
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> global_epoch{1};
+    alignas(CACHE_LINE_SIZE) std::atomic<long> pending{0};
+    std::atomic<long> peak_pending{0};
+    std::atomic<std::size_t> pending_bytes{0};
+    std::atomic<std::size_t> peak_pending_bytes{0};
+    std::atomic<long> epoch_advances{0};
+
+    Slot slots[MAX_THREADS];
+    std::unique_ptr<Local> locals[MAX_THREADS];  // Se crea en el primer retire() del hilo
+
+    static void update_max(std::atomic<long>& peak, long value) {
+        long current = peak.load(std::memory_order_relaxed);
+        while (value > current &&
+               !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    static void update_max(std::atomic<std::size_t>& peak, std::size_t value) {
+        std::size_t current = peak.load(std::memory_order_relaxed);
+        while (value > current &&
+               !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    /**
+     * Avanzar la época si todos los hilos activos ya están en la actual
+     */
+    void try_advance() {
+        uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+        for (int i = 0; i < MAX_THREADS; i++) {
+            uint64_t state = slots[i].state.load(std::memory_order_seq_cst);
+            if ((state & 1) && (state >> 1) != epoch) return;  // Lector rezagado
+        }
+        if (global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst)) {
+            epoch_advances.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Liberar lo que el hilo retiró hace al menos dos épocas
+     */
+    void reclaim(Local& local) {
+        uint64_t safe_epoch = global_epoch.load(std::memory_order_acquire);
+        uint64_t now = now_ns();
+        long freed = 0;
+        std::size_t freed_bytes = 0;
+        while (local.limbo_head < local.limbo.size() &&
+               local.limbo[local.limbo_head].epoch + 2 <= safe_epoch) {
+            Retired& r = local.limbo[local.limbo_head++];
+            local.latency.record(now - r.retire_ns);
+            r.deleter(r.ptr);
+            freed++;
+            freed_bytes += r.bytes;
+        }
+        if (freed == 0) return;
+
+        local.reclaimed += freed;
+        pending.fetch_sub(freed, std::memory_order_relaxed);
+        pending_bytes.fetch_sub(freed_bytes, std::memory_order_relaxed);
+        if (local.limbo_head == local.limbo.size()) {
+            local.limbo.clear();
+            local.limbo_head = 0;
+        } else if (local.limbo_head > local.limbo.size() / 2) {
+            local.limbo.erase(local.limbo.begin(), local.limbo.begin() + local.limbo_head);
+            local.limbo_head = 0;
+        }
+    }
+
+public:
+    EbrDomain() = default;
+
+    /**
+     * Libera todo lo pendiente: solo cuando ningún hilo usa ya el dominio
+     */
+    ~EbrDomain() {
+        for (int i = 0; i < MAX_THREADS; i++) {
+            if (!locals[i]) continue;
+            Local& local = *locals[i];
+            for (std::size_t j = local.limbo_head; j < local.limbo.size(); j++) {
+                local.limbo[j].deleter(local.limbo[j].ptr);
+            }
+        }
+    }
+
+    EbrDomain(const EbrDomain&) = delete;
+    EbrDomain& operator=(const EbrDomain&) = delete;
+
+    /**
+     * Entrar a una sección crítica de lectura (no bloquea nunca)
+     */
+    void enter() {
+        Slot& slot = slots[thread_index()];
+        slot.state.store((global_epoch.load(std::memory_order_relaxed) << 1) | 1,
+                         std::memory_order_relaxed);
+        // La época publicada debe verse antes de cualquier lectura de la
+        // estructura; pareja del escaneo seq_cst de try_advance
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void exit() {
+        slots[thread_index()].state.store(0, std::memory_order_release);
+    }
+
+    /**
+     * Diferir la liberación de p hasta que pase un periodo de gracia
+     * (p ya debe ser inalcanzable para lectores nuevos)
+     */
+    template<typename T>
+    void retire(T* p) {
+        std::unique_ptr<Local>& slot_local = locals[thread_index()];
+        if (!slot_local) slot_local.reset(new Local());
+        Local& local = *slot_local;
+        // El desenlace de p debe verse antes de leer la época; pareja de la
+        // barrera de enter() (si no, un lector podría entrar y aún ver p)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+        local.limbo.push_back({p, [](void* q) { delete static_cast<T*>(q); },
+                               epoch, now_ns(), sizeof(T)});
+        local.retired++;
+        update_max(peak_pending, pending.fetch_add(1, std::memory_order_relaxed) + 1);
+        update_max(peak_pending_bytes,
+                   pending_bytes.fetch_add(sizeof(T), std::memory_order_relaxed) + sizeof(T));
+
+        if (++local.since_advance >= ADVANCE_EVERY) {
+            local.since_advance = 0;
+            try_advance();
+            reclaim(local);
+        }
+    }
+
+    /**
+     * Estadísticas acumuladas (con los hilos detenidos)
+     */
+    EbrStats stats() const {
+        EbrStats s;
+        for (int i = 0; i < MAX_THREADS; i++) {
+            if (!locals[i]) continue;
+            s.retired += locals[i]->retired;
+            s.reclaimed += locals[i]->reclaimed;
+            s.latency.merge(locals[i]->latency);
+        }
+        s.pending = pending.load(std::memory_order_relaxed);
+        s.peak_pending = peak_pending.load(std::memory_order_relaxed);
+        s.peak_pending_bytes = peak_pending_bytes.load(std::memory_order_relaxed);
+        s.epoch_advances = epoch_advances.load(std::memory_order_relaxed);
+        return s;
+    }
+};
+
+// ============================================================================
+// GUARDIA RAII
+// ============================================================================
+
+/**
+ * Sección crítica de lectura mientras viva el objeto
+ */
+class EbrGuard {
+private:
+    EbrDomain& domain;
+
+public:
+    explicit EbrGuard(EbrDomain& d) : domain(d) { domain.enter(); }
+    ~EbrGuard() { domain.exit(); }
+
+    EbrGuard(const EbrGuard&) = delete;
+    EbrGuard& operator=(const EbrGuard&) = delete;
+};
@@ -0,0 +1,250 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Tabla Hash Plana con Direccionamiento Abierto
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Tabla hash int -> int sin nodos: claves, valores y bytes de
+ *           control en arreglos contiguos, sondeando 16 slots por
+ *           instrucción (estilo Swiss table). No es thread-safe: los
+ *           envoltorios con locks viven en cada práctica
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "huge_pages.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ============================================================================
+// CLASE FLATHASHTABLE
+// ============================================================================
+
+/**
+ * Tabla de direccionamiento abierto por grupos de 16 slots
+ *
+ * - Cada slot tiene un byte de control: EMPTY (0x80), DELETED (0xFE) u
+ *   ocupado con los 7 bits bajos del hash (h2). Los 16 bytes de un grupo se
+ *   comparan contra h2 con una sola instrucción SSE2 (pcmpeqb + pmovmskb):
+ *   solo se leen claves de los slots cuyo h2 coincide (~1/128 de falsos
+ *   positivos)
+ * - El resto del hash (h1) elige el grupo inicial; si el grupo está lleno se
+ *   sigue con sondeo triangular entre grupos (recorre todos si su número es
+ *   potencia de 2). Una búsqueda termina en el primer grupo con un EMPTY
+ * - Borrar deja DELETED solo si el grupo no tiene EMPTY (alguna búsqueda pudo
+ *   haber pasado de largo); los DELETED cuentan como ocupados para el factor
+ *   de carga y desaparecen al rehacer la tabla
+ * - Carga máxima 7/8: siempre queda algún EMPTY y las búsquedas terminan
+ *
+ * Control, claves y valores comparten un solo bloque alineado a línea de
+ * caché: una búsqueda toca una línea de control y, casi siempre, una de
+ * claves y una de valores, sin perseguir punteros.
+ */
+class FlatHashTable {
+public:
+    static constexpr int GROUP_SIZE = 16;
+    static constexpr int8_t CTRL_EMPTY = (int8_t)0x80;
+    static constexpr int8_t CTRL_DELETED = (int8_t)0xFE;
+
+private:
+    HugeBuffer storage;
+    int8_t* ctrl = nullptr;
+    int* keys = nullptr;
+    int* values = nullptr;
+    std::size_t slots = 0;         // Potencia de 2, múltiplo de GROUP_SIZE
+    std::size_t used = 0;          // Slots ocupados
+    std::size_t growth_left = 0;   // Inserciones en slots EMPTY antes de rehacer
+
+    // Mezcla de 64 bits (finalizador de MurmurHash3): h1 y h2 salen de bits
+    // distintos, así que claves del mismo grupo no comparten h2 por construcción
+    static uint64_t hash(int key) {
+        uint64_t h = (uint32_t)key;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static int8_t h2(uint64_t h) { return (int8_t)(h & 0x7f); }
+    static std::size_t h1(uint64_t h) { return (std::size_t)(h >> 7); }
+
+    // Máscara de 16 bits: bit i = el byte i del grupo es igual a tag
+    static uint32_t match(const int8_t* group, int8_t tag) {
+#if defined(__SSE2__)
+        __m128i ctrl_bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_bytes, _mm_set1_epi8(tag)));
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < GROUP_SIZE; i++) {
+            if (group[i] == tag) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    // EMPTY y DELETED son los únicos bytes con el bit alto encendido
+    static uint32_t match_free(const int8_t* group) {
+#if defined(__SSE2__)
+        return (uint32_t)_mm_movemask_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(group)));
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < GROUP_SIZE; i++) {
+            if (group[i] < 0) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    std::size_t group_mask() const { return slots / GROUP_SIZE - 1; }
+
+    /**
+     * Slot que contiene key, o slots (fin) si no está
+     */
+    std::size_t find_slot(int key) const {
+        uint64_t h = hash(key);
+        int8_t tag = h2(h);
+        std::size_t mask = group_mask();
+        std::size_t group = h1(h) & mask;
+        for (std::size_t step = 1;; group = (group + step++) & mask) {
+            const int8_t* g = ctrl + group * GROUP_SIZE;
+            for (uint32_t m = match(g, tag); m; m &= m - 1) {
+                std::size_t slot = group * GROUP_SIZE + __builtin_ctz(m);
+                if (keys[slot] == key) return slot;
+            }
+            if (match(g, CTRL_EMPTY)) return slots;
+        }
+    }
+
+    /**
+     * Primer slot libre (EMPTY o DELETED) en la secuencia de sondeo de key
+     */
+    std::size_t find_free_slot(uint64_t h) const {
+        std::size_t mask = group_mask();
+        std::size_t group = h1(h) & mask;
+        for (std::size_t step = 1;; group = (group + step++) & mask) {
+            uint32_t m = match_free(ctrl + group * GROUP_SIZE);
+            if (m) return group * GROUP_SIZE + __builtin_ctz(m);
+        }
+    }
+
+    void allocate(std::size_t num_slots) {
+        std::size_t ctrl_bytes = round_up(num_slots, CACHE_LINE_SIZE);
+        storage.allocate(ctrl_bytes + 2 * num_slots * sizeof(int), false);
+        char* base = static_cast<char*>(storage.data());
+        ctrl = reinterpret_cast<int8_t*>(base);
+        keys = reinterpret_cast<int*>(base + ctrl_bytes);
+        values = keys + num_slots;
+        for (std::size_t i = 0; i < num_slots; i++) ctrl[i] = CTRL_EMPTY;
+        slots = num_slots;
+        used = 0;
+        growth_left = num_slots - num_slots / 8;
+    }
+
+    /**
+     * Rehacer en una tabla de num_slots (crece o solo limpia DELETED)
+     */
+    void rehash(std::size_t num_slots) {
+        HugeBuffer old_storage = std::move(storage);
+        const int8_t* old_ctrl = ctrl;
+        const int* old_keys = keys;
+        const int* old_values = values;
+        std::size_t old_slots = slots;
+
+        allocate(num_slots);
+        for (std::size_t i = 0; i < old_slots; i++) {
+            if (old_ctrl[i] < 0) continue;
+            uint64_t h = hash(old_keys[i]);
+            std::size_t slot = find_free_slot(h);
+            ctrl[slot] = h2(h);
+            keys[slot] = old_keys[i];
+            values[slot] = old_values[i];
+            used++;
+            growth_left--;
+        }
+    }
+
+    static std::size_t slots_for(std::size_t expected_entries) {
+        std::size_t needed = expected_entries + expected_entries / 7 + 1;  // Carga <= 7/8
+        std::size_t rounded = round_up_pow2(needed);
+        return rounded < (std::size_t)GROUP_SIZE ? GROUP_SIZE : rounded;
+    }
+
+public:
+    /**
+     * @param expected_entries: entradas que caben sin rehacer la tabla
+     */
+    explicit FlatHashTable(std::size_t expected_entries = 0) {
+        allocate(slots_for(expected_entries));
+    }
+
+    FlatHashTable(const FlatHashTable&) = delete;
+    FlatHashTable& operator=(const FlatHashTable&) = delete;
+
+    /**
+     * Asegurar espacio para expected_entries sin rehacer durante las inserciones
+     */
+    void reserve(std::size_t expected_entries) {
+        std::size_t needed = slots_for(expected_entries);
+        if (needed > slots) rehash(needed);
+    }
+
+    bool find(int key, int* value) const {
+        std::size_t slot = find_slot(key);
+        if (slot == slots) return false;
+        *value = values[slot];
+        return true;
+    }
+
+    /**
+     * Insertar o actualizar
+     * @return: true si la clave era nueva
+     */
+    bool insert_or_assign(int key, int value) {
+        std::size_t slot = find_slot(key);
+        if (slot != slots) {
+            values[slot] = value;
+            return false;
+        }
+
+        uint64_t h = hash(key);
+        slot = find_free_slot(h);
+        if (ctrl[slot] == CTRL_EMPTY && growth_left == 0) {
+            // Muchos DELETED: limpiar sin crecer; si no, duplicar
+            rehash(used + 1 <= slots / 2 ? slots : slots * 2);
+            slot = find_free_slot(h);
+        }
+        if (ctrl[slot] == CTRL_EMPTY) growth_left--;
+        ctrl[slot] = h2(h);
+        keys[slot] = key;
+        values[slot] = value;
+        used++;
+        return true;
+    }
+
+    bool erase(int key) {
+        std::size_t slot = find_slot(key);
+        if (slot == slots) return false;
+        const int8_t* group = ctrl + (slot & ~(std::size_t)(GROUP_SIZE - 1));
+        if (match(group, CTRL_EMPTY)) {
+            ctrl[slot] = CTRL_EMPTY;   // Ninguna búsqueda pasó de largo este grupo
+            growth_left++;
+        } else {
+            ctrl[slot] = CTRL_DELETED;
+        }
+        used--;
+        return true;
+    }
+
+    std::size_t size() const { return used; }
+    std::size_t capacity() const { return slots; }
+    std::size_t memory_bytes() const { return storage.size(); }
+};
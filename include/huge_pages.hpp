@@ -0,0 +1,156 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Memoria para Búferes con Páginas Grandes
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Reservar búferes grandes (colas, arenas) alineados y, si se
+ *           pide, respaldados por páginas de 2 MB para reducir fallos de TLB
+ */
+
+#pragma once
+
+#include <sys/mman.h>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include "cacheline.hpp"
+
+// ============================================================================
+// CONSTANTES Y UTILIDADES
+// ============================================================================
+
+constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;  // Página grande x86-64
+
+/**
+ * Menor potencia de 2 >= value (1 para value = 0)
+ */
+constexpr std::size_t round_up_pow2(std::size_t value) {
+    std::size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+constexpr std::size_t round_up(std::size_t value, std::size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// ============================================================================
+// CLASE HUGEBUFFER
+// ============================================================================
+
+/**
+ * Bloque de memoria propio (RAII), alineado al menos a línea de caché
+ *
+ * Con huge = true se intenta, en orden:
+ *   1. mmap(MAP_HUGETLB): páginas de 2 MB reservadas (requiere
+ *      vm.nr_hugepages > 0)
+ *   2. mmap + madvise(MADV_HUGEPAGE): Transparent Huge Pages, el kernel
+ *      decide (puede quedar en páginas de 4 KB)
+ * Sin huge (o si todo falla) se usa aligned_alloc.
+ *
+ * La memoria se toca completa al reservarla para que los fallos de página
+ * no caigan dentro de la región medida.
+ */
+class HugeBuffer {
+public:
+    enum class Backing { NONE, HEAP, HUGETLB, THP };
+
+private:
+    void* ptr = nullptr;
+    std::size_t mapped_bytes = 0;
+    Backing kind = Backing::NONE;
+
+public:
+    HugeBuffer() = default;
+    HugeBuffer(std::size_t bytes, bool huge) { allocate(bytes, huge); }
+    ~HugeBuffer() { release(); }
+
+    HugeBuffer(const HugeBuffer&) = delete;
+    HugeBuffer& operator=(const HugeBuffer&) = delete;
+
+    HugeBuffer(HugeBuffer&& other) noexcept
+        : ptr(other.ptr), mapped_bytes(other.mapped_bytes), kind(other.kind) {
+        other.ptr = nullptr;
+        other.mapped_bytes = 0;
+        other.kind = Backing::NONE;
+    }
+
+    HugeBuffer& operator=(HugeBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            ptr = other.ptr;
+            mapped_bytes = other.mapped_bytes;
+            kind = other.kind;
+            other.ptr = nullptr;
+            other.mapped_bytes = 0;
+            other.kind = Backing::NONE;
+        }
+        return *this;
+    }
+
+    /**
+     * Reservar bytes (libera lo anterior)
+     * @return: false solo si no se pudo reservar memoria de ningún tipo
+     */
+    bool allocate(std::size_t bytes, bool huge) {
+        release();
+        if (bytes == 0) bytes = 1;
+
+        if (huge) {
+            std::size_t rounded = round_up(bytes, HUGE_PAGE_SIZE);
+            void* p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                ptr = p;
+                mapped_bytes = rounded;
+                kind = Backing::HUGETLB;
+            } else {
+                p = mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (p != MAP_FAILED) {
+                    madvise(p, rounded, MADV_HUGEPAGE);  // Sugerencia: puede ignorarse
+                    ptr = p;
+                    mapped_bytes = rounded;
+                    kind = Backing::THP;
+                }
+            }
+        }
+
+        if (!ptr) {
+            std::size_t rounded = round_up(bytes, CACHE_LINE_SIZE);
+            ptr = std::aligned_alloc(CACHE_LINE_SIZE, rounded);
+            if (!ptr) return false;
+            mapped_bytes = rounded;
+            kind = Backing::HEAP;
+        }
+
+        std::memset(ptr, 0, mapped_bytes);  // Pre-fault
+        return true;
+    }
+
+    void release() {
+        if (kind == Backing::HUGETLB || kind == Backing::THP) {
+            munmap(ptr, mapped_bytes);
+        } else if (kind == Backing::HEAP) {
+            std::free(ptr);
+        }
+        ptr = nullptr;
+        mapped_bytes = 0;
+        kind = Backing::NONE;
+    }
+
+    void* data() const { return ptr; }
+    std::size_t size() const { return mapped_bytes; }
+    Backing backing() const { return kind; }
+
+    const char* describe() const {
+        switch (kind) {
+            case Backing::HUGETLB: return "páginas de 2 MB (MAP_HUGETLB)";
+            case Backing::THP:     return "THP (madvise MADV_HUGEPAGE)";
+            case Backing::HEAP:    return "heap (páginas de 4 KB)";
+            default:               return "sin reservar";
+        }
+    }
+};
@@ -0,0 +1,229 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Distribuciones de Claves para Cargas de Trabajo
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Generar de antemano la secuencia de operaciones de cada hilo
+ *           (uniforme, Zipf, conjunto caliente o recorrido secuencial) para
+ *           que el RNG no quede dentro de la región medida
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// OPERACIONES PRE-GENERADAS
+// ============================================================================
+
+enum OpKind : uint8_t {
+    OP_GET = 0,
+    OP_PUT = 1,
+    OP_REMOVE = 2
+};
+
+/**
+ * Una operación: 12 bytes con el relleno explícito (también es el registro
+ * de las trazas binarias, que se usan directamente desde el mmap)
+ */
+struct WorkloadOp {
+    uint8_t kind;       // OpKind
+    uint8_t pad[3];
+    int32_t key;
+    int32_t value;      // Solo para OP_PUT
+};
+static_assert(sizeof(WorkloadOp) == 12, "WorkloadOp es el formato de la traza");
+
+/**
+ * Secuencia de operaciones de un hilo (de un vector o de una traza en disco)
+ */
+struct OpStream {
+    const WorkloadOp* ops;
+    long count;
+};
+
+// ============================================================================
+// CLASE KEYDISTRIBUTION
+// ============================================================================
+
+/**
+ * Distribución de claves sobre [0, key_range)
+ *
+ * - uniform: todas las claves con la misma probabilidad
+ * - zipf:THETA: la clave de rango r (0 = la más popular) sale con
+ *   probabilidad proporcional a 1 / (r + 1)^THETA. THETA = 0 es uniforme,
+ *   0.99 es el valor típico de YCSB
+ * - hotset:OPS:KEYS: OPS% de las operaciones caen en KEYS% de las claves
+ * - sequential: cada hilo recorre las claves en orden desde su propio
+ *   desplazamiento (range / hilos * id), dando la vuelta al final
+ *
+ * Los rangos de popularidad se asignan a claves con una permutación fija:
+ * las claves calientes quedan repartidas en buckets distintos en vez de ser
+ * 0, 1, 2, ... (que con un hash débil podrían compartir bucket).
+ */
+class KeyDistribution {
+public:
+    enum class Kind { UNIFORM, ZIPF, HOTSET, SEQUENTIAL };
+
+private:
+    Kind kind = Kind::UNIFORM;
+    double theta = 0.99;
+    double hot_ops_pct = 90.0;
+    double hot_keys_pct = 10.0;
+
+    int key_range = 0;
+    std::vector<int> rank_to_key;    // Permutación: rango de popularidad -> clave
+    std::vector<double> zipf_cdf;    // CDF acumulada por rango (solo ZIPF)
+    int hot_keys = 0;                // Claves en el conjunto caliente (solo HOTSET)
+
+public:
+    /**
+     * Leer "uniform", "zipf[:THETA]", "hotset[:OPS:KEYS]" o "sequential"
+     * @return: false si el texto no es válido
+     */
+    bool parse(const char* text) {
+        if (strcmp(text, "uniform") == 0) {
+            kind = Kind::UNIFORM;
+            return true;
+        }
+        if (strcmp(text, "sequential") == 0) {
+            kind = Kind::SEQUENTIAL;
+            return true;
+        }
+        if (strncmp(text, "zipf", 4) == 0 && (text[4] == '\0' || text[4] == ':')) {
+            kind = Kind::ZIPF;
+            if (text[4] == ':') theta = std::atof(text + 5);
+            return theta >= 0.0 && theta <= 10.0;
+        }
+        if (strncmp(text, "hotset", 6) == 0 && (text[6] == '\0' || text[6] == ':')) {
+            kind = Kind::HOTSET;
+            if (text[6] == ':' &&
+                sscanf(text + 7, "%lf:%lf", &hot_ops_pct, &hot_keys_pct) != 2) {
+                return false;
+            }
+            return hot_ops_pct >= 0.0 && hot_ops_pct <= 100.0 &&
+                   hot_keys_pct > 0.0 && hot_keys_pct <= 100.0;
+        }
+        return false;
+    }
+
+    /**
+     * Preparar tablas para claves en [0, range) (llamar una vez antes de generate)
+     */
+    void prepare(int range) {
+        key_range = range;
+        rank_to_key.resize(range);
+        for (int i = 0; i < range; i++) rank_to_key[i] = i;
+        std::shuffle(rank_to_key.begin(), rank_to_key.end(), std::mt19937(2025));
+
+        zipf_cdf.clear();
+        if (kind == Kind::ZIPF) {
+            zipf_cdf.resize(range);
+            double sum = 0.0;
+            for (int r = 0; r < range; r++) {
+                sum += 1.0 / std::pow((double)(r + 1), theta);
+                zipf_cdf[r] = sum;
+            }
+            for (double& c : zipf_cdf) c /= sum;
+        }
+        hot_keys = std::max(1, (int)(range * hot_keys_pct / 100.0));
+    }
+
+    /**
+     * Siguiente clave; seq_pos es el estado del recorrido secuencial del hilo
+     */
+    int next_key(std::mt19937& rng, long* seq_pos) const {
+        switch (kind) {
+            case Kind::ZIPF: {
+                double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+                int rank = (int)(std::lower_bound(zipf_cdf.begin(), zipf_cdf.end(), u) -
+                                 zipf_cdf.begin());
+                return rank_to_key[std::min(rank, key_range - 1)];
+            }
+            case Kind::HOTSET: {
+                bool hot = std::uniform_real_distribution<double>(0.0, 100.0)(rng) < hot_ops_pct;
+                if (hot || hot_keys == key_range) {
+                    return rank_to_key[std::uniform_int_distribution<int>(0, hot_keys - 1)(rng)];
+                }
+                return rank_to_key[std::uniform_int_distribution<int>(hot_keys, key_range - 1)(rng)];
+            }
+            case Kind::SEQUENTIAL: {
+                int key = (int)(*seq_pos % key_range);
+                (*seq_pos)++;
+                return key;
+            }
+            default:
+                return std::uniform_int_distribution<int>(0, key_range - 1)(rng);
+        }
+    }
+
+    /**
+     * Generar las operaciones de un hilo
+     * @param read_pct: % de get(); del resto, remove_pct% son remove()
+     */
+    std::vector<WorkloadOp> generate(long count, int read_pct, int remove_pct,
+                                     int thread_id, int num_threads, uint32_t seed) const {
+        std::vector<WorkloadOp> ops(count, WorkloadOp{});
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> op_dist(0, 99);
+        std::uniform_int_distribution<int> val_dist(1, 1000);
+        long seq_pos = (long)key_range / std::max(1, num_threads) * thread_id;
+
+        for (WorkloadOp& op : ops) {
+            op.key = next_key(rng, &seq_pos);
+            if (op_dist(rng) < read_pct) {
+                op.kind = OP_GET;
+                op.value = 0;
+            } else if (remove_pct > 0 && op_dist(rng) < remove_pct) {
+                op.kind = OP_REMOVE;
+                op.value = 0;
+            } else {
+                op.kind = OP_PUT;
+                op.value = val_dist(rng);
+            }
+        }
+        return ops;
+    }
+
+    /**
+     * Fracción de los accesos que recibe la clave más popular (según la
+     * distribución teórica; para sequential y uniform es 1/range)
+     */
+    double top_key_share() const {
+        switch (kind) {
+            case Kind::ZIPF: return zipf_cdf.empty() ? 0.0 : zipf_cdf[0];
+            case Kind::HOTSET: return hot_ops_pct / 100.0 / hot_keys;
+            default: return key_range ? 1.0 / key_range : 0.0;
+        }
+    }
+
+    std::string describe() const {
+        char text[96];
+        switch (kind) {
+            case Kind::ZIPF:
+                snprintf(text, sizeof(text), "zipf (theta = %.2f)", theta);
+                break;
+            case Kind::HOTSET:
+                snprintf(text, sizeof(text), "hotset (%.0f%% de las ops en %.0f%% de las claves)",
+                         hot_ops_pct, hot_keys_pct);
+                break;
+            case Kind::SEQUENTIAL:
+                snprintf(text, sizeof(text), "sequential (recorrido por hilo)");
+                break;
+            default:
+                snprintf(text, sizeof(text), "uniform");
+                break;
+        }
+        return text;
+    }
+};
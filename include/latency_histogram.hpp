@@ -0,0 +1,137 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Histograma de Latencias Log-Lineal
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Registrar millones de latencias por hilo sin guardar cada
+ *           muestra y obtener percentiles (p50/p99/p99.9) al final
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// ============================================================================
+// CLASE LATENCYHISTOGRAM
+// ============================================================================
+
+/**
+ * Histograma log-lineal al estilo HDR
+ *
+ * Cada potencia de 2 se divide en SUB_BUCKETS cubetas lineales, así que el
+ * error relativo de cualquier percentil es a lo sumo 1/SUB_BUCKETS (6.25%)
+ * en todo el rango de uint64_t. Valores < SUB_BUCKETS se guardan exactos.
+ *
+ * record() es una suma sobre un arreglo fijo, sin memoria dinámica: cada hilo
+ * mantiene el suyo y se combinan con merge() cuando todos terminaron.
+ * La unidad de los valores la decide quien registra (ns, ciclos, ...).
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+private:
+    uint64_t counts[NUM_BUCKETS];
+    uint64_t total = 0;
+    uint64_t min_value = UINT64_MAX;
+    uint64_t max_value = 0;
+    double sum = 0.0;
+
+    static int bucket_of(uint64_t value) {
+        if (value < (uint64_t)SUB_BUCKETS) return (int)value;
+        int exponent = 63 - __builtin_clzll(value);           // >= SUB_BUCKET_BITS
+        int shift = exponent - SUB_BUCKET_BITS;
+        int sub = (int)((value >> shift) & (SUB_BUCKETS - 1));
+        return (shift + 1) * SUB_BUCKETS + sub;
+    }
+
+    // Mayor valor que cae en la cubeta (valor "equivalente" reportado)
+    static uint64_t bucket_upper(int index) {
+        if (index < SUB_BUCKETS) return (uint64_t)index;
+        int shift = index / SUB_BUCKETS - 1;
+        uint64_t sub = (uint64_t)(index % SUB_BUCKETS);
+        uint64_t lower = ((uint64_t)SUB_BUCKETS + sub) << shift;
+        return lower + ((1ull << shift) - 1);
+    }
+
+public:
+    LatencyHistogram() {
+        reset();
+    }
+
+    void reset() {
+        std::memset(counts, 0, sizeof(counts));
+        total = 0;
+        min_value = UINT64_MAX;
+        max_value = 0;
+        sum = 0.0;
+    }
+
+    /**
+     * Registrar una muestra (O(1), sin locks: solo el hilo dueño escribe)
+     */
+    void record(uint64_t value) {
+        counts[bucket_of(value)]++;
+        total++;
+        sum += (double)value;
+        if (value < min_value) min_value = value;
+        if (value > max_value) max_value = value;
+    }
+
+    /**
+     * Acumular las muestras de otro histograma (después de que su hilo terminó)
+     */
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        if (other.min_value < min_value) min_value = other.min_value;
+        if (other.max_value > max_value) max_value = other.max_value;
+    }
+
+    /**
+     * Valor bajo el cual cae el porcentaje p de las muestras (0 < p <= 100)
+     * Se reporta el extremo superior de la cubeta, acotado por el máximo real
+     */
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t rank = (uint64_t)(p / 100.0 * (double)total + 0.5);
+        if (rank < 1) rank = 1;
+        if (rank > total) rank = total;
+
+        uint64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint64_t upper = bucket_upper(i);
+                return upper < max_value ? upper : max_value;
+            }
+        }
+        return max_value;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? min_value : 0; }
+    uint64_t max() const { return max_value; }
+    double mean() const { return total ? sum / (double)total : 0.0; }
+
+    /**
+     * Imprimir p50/p99/p99.9/max en una línea (valores en ns)
+     */
+    void print_summary(const char* label) const {
+        printf("%s: n=%llu p50=%llu ns p99=%llu ns p99.9=%llu ns max=%llu ns\n",
+               label, (unsigned long long)total,
+               (unsigned long long)percentile(50.0),
+               (unsigned long long)percentile(99.0),
+               (unsigned long long)percentile(99.9),
+               (unsigned long long)max_value);
+    }
+};
@@ -0,0 +1,163 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Pool de Nodos con Cachés por Hilo
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Sacar malloc/free de las secciones críticas: los nodos salen de
+ *           slabs reservados de antemano y se reciclan con listas libres,
+ *           primero la del propio hilo y luego una central compartida
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+#include "cacheline.hpp"
+#include "huge_pages.hpp"
+#include "thread_index.hpp"
+
+// ============================================================================
+// CLASE NODEPOOL
+// ============================================================================
+
+/**
+ * Asignador de objetos T de tamaño fijo
+ *
+ * - Memoria: slabs contiguos (HugeBuffer, ya tocados). El constructor reserva
+ *   preallocate nodos; si se agotan se agrega otro slab de SLAB_NODES
+ * - Cada hilo (thread_index()) tiene una lista libre propia sin atomics.
+ *   create() saca de ella y destroy() devuelve a ella: el caso común son dos
+ *   escrituras de puntero
+ * - Cuando la lista del hilo se vacía toma BATCH nodos de la lista central
+ *   (un mutex), y cuando pasa de 2 * BATCH le devuelve BATCH: los nodos
+ *   migran entre hilos que insertan y hilos que eliminan
+ * - refill_local() deja al menos un nodo en la lista del hilo: llamada antes
+ *   de tomar el lock de una estructura, create() ya no toca el mutex central
+ *   ni malloc dentro de la sección crítica
+ *
+ * Los nodos vivos al destruir el pool no se destruyen (su dueño debe
+ * devolverlos con destroy() antes; la memoria se libera igual).
+ */
+template<typename T>
+class NodePool {
+public:
+    static constexpr int BATCH = 64;
+    static constexpr std::size_t SLAB_NODES = 4096;
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    static constexpr std::size_t NODE_ALIGN =
+        alignof(T) > alignof(FreeNode) ? alignof(T) : alignof(FreeNode);
+    static constexpr std::size_t NODE_BYTES =
+        round_up(sizeof(T) > sizeof(FreeNode) ? sizeof(T) : sizeof(FreeNode), NODE_ALIGN);
+    static_assert(NODE_ALIGN <= CACHE_LINE_SIZE, "NodePool: alineación mayor a una línea");
+
+    struct alignas(CACHE_LINE_SIZE) LocalList {
+        FreeNode* head = nullptr;
+        int count = 0;
+    };
+
+    LocalList locals[MAX_THREAD_INDEX];
+
+    alignas(CACHE_LINE_SIZE) std::mutex central_mutex;
+    FreeNode* central_head = nullptr;
+    std::size_t central_count = 0;
+    std::vector<HugeBuffer> slabs;
+    long central_transfers = 0;   // Lotes movidos entre listas de hilo y la central
+
+    // Encadenar un slab nuevo a la lista central (con central_mutex tomado)
+    void add_slab(std::size_t nodes) {
+        slabs.emplace_back(nodes * NODE_BYTES, false);
+        char* base = static_cast<char*>(slabs.back().data());
+        for (std::size_t i = nodes; i-- > 0;) {
+            FreeNode* node = reinterpret_cast<FreeNode*>(base + i * NODE_BYTES);
+            node->next = central_head;
+            central_head = node;
+        }
+        central_count += nodes;
+    }
+
+    void take_batch(LocalList& local) {
+        std::lock_guard<std::mutex> lock(central_mutex);
+        if (central_count == 0) add_slab(SLAB_NODES);
+        for (int i = 0; i < BATCH && central_head; i++) {
+            FreeNode* node = central_head;
+            central_head = node->next;
+            central_count--;
+            node->next = local.head;
+            local.head = node;
+            local.count++;
+        }
+        central_transfers++;
+    }
+
+    void give_batch(LocalList& local) {
+        std::lock_guard<std::mutex> lock(central_mutex);
+        for (int i = 0; i < BATCH; i++) {
+            FreeNode* node = local.head;
+            local.head = node->next;
+            local.count--;
+            node->next = central_head;
+            central_head = node;
+            central_count++;
+        }
+        central_transfers++;
+    }
+
+public:
+    explicit NodePool(std::size_t preallocate = SLAB_NODES) {
+        if (preallocate > 0) add_slab(preallocate);
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /**
+     * Garantizar un nodo en la lista del hilo (puede tomar el mutex central)
+     */
+    void refill_local() {
+        LocalList& local = locals[thread_index()];
+        if (!local.head) take_batch(local);
+    }
+
+    template<typename... Args>
+    T* create(Args&&... args) {
+        LocalList& local = locals[thread_index()];
+        if (!local.head) take_batch(local);
+        FreeNode* node = local.head;
+        local.head = node->next;
+        local.count--;
+        return new (static_cast<void*>(node)) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* object) {
+        object->~T();
+        LocalList& local = locals[thread_index()];
+        FreeNode* node = reinterpret_cast<FreeNode*>(object);
+        node->next = local.head;
+        local.head = node;
+        local.count++;
+        if (local.count > 2 * BATCH) give_batch(local);
+    }
+
+    /**
+     * Bytes reservados en slabs y traspasos con la lista central
+     * (leer con los hilos detenidos)
+     */
+    std::size_t reserved_bytes() const {
+        std::size_t bytes = 0;
+        for (const HugeBuffer& slab : slabs) bytes += slab.size();
+        return bytes;
+    }
+    std::size_t num_slabs() const { return slabs.size(); }
+    long transfers() const { return central_transfers; }
+};
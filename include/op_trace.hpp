@@ -0,0 +1,208 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Trazas Binarias de Operaciones
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Guardar y reproducir la secuencia (op, clave, valor) de cada
+ *           hilo: trazas sintéticas o capturadas de tráfico real, mapeadas
+ *           con mmap y leídas en su lugar durante la medición
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "key_distribution.hpp"
+
+// ============================================================================
+// FORMATO EN DISCO
+// ============================================================================
+
+/**
+ * Archivo (little-endian, todo alineado a 64 bytes):
+ *
+ *   TraceHeader                          64 bytes
+ *   TraceStreamEntry[num_threads]        16 bytes c/u (offset y cantidad)
+ *   relleno hasta múltiplo de 64
+ *   registros WorkloadOp del hilo 0      12 bytes c/u: kind, 3 de relleno,
+ *   relleno hasta múltiplo de 64                        key, value (int32)
+ *   registros del hilo 1 ...
+ *
+ * kind: 0 = get, 1 = put, 2 = remove. Para convertir una captura de
+ * producción basta con escribir este formato; la traza parte de un mapa vacío.
+ */
+constexpr char TRACE_MAGIC[8] = {'L', '6', 'T', 'R', 'A', 'C', 'E', '\0'};
+constexpr uint32_t TRACE_VERSION = 1;
+
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_threads;
+    uint32_t record_size;       // sizeof(WorkloadOp)
+    uint32_t reserved[11];
+};
+static_assert(sizeof(TraceHeader) == 64, "TraceHeader ocupa una línea");
+
+struct TraceStreamEntry {
+    uint64_t offset;            // Bytes desde el inicio del archivo
+    uint64_t count;             // Registros
+};
+
+// ============================================================================
+// CLASE OPTRACE
+// ============================================================================
+
+/**
+ * Traza cargada con mmap (solo lectura). load() valida encabezado, límites
+ * y cada registro; esa pasada además trae las páginas a memoria, así que los
+ * fallos de página quedan fuera de la región medida.
+ */
+class OpTrace {
+private:
+    void* base = nullptr;
+    std::size_t bytes = 0;
+    std::vector<OpStream> streams;
+
+    static std::size_t align64(std::size_t value) { return (value + 63) & ~(std::size_t)63; }
+
+    void unmap() {
+        if (base) munmap(base, bytes);
+        base = nullptr;
+        bytes = 0;
+        streams.clear();
+    }
+
+public:
+    OpTrace() = default;
+    ~OpTrace() { unmap(); }
+
+    OpTrace(const OpTrace&) = delete;
+    OpTrace& operator=(const OpTrace&) = delete;
+
+    /**
+     * Escribir una traza con las operaciones de cada hilo
+     * @return: false (y *error) si falla la escritura
+     */
+    static bool write(const char* path, const std::vector<std::vector<WorkloadOp>>& per_thread,
+                      std::string* error) {
+        FILE* file = fopen(path, "wb");
+        if (!file) {
+            *error = std::string("no se pudo crear: ") + strerror(errno);
+            return false;
+        }
+
+        TraceHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        header.version = TRACE_VERSION;
+        header.num_threads = (uint32_t)per_thread.size();
+        header.record_size = sizeof(WorkloadOp);
+
+        std::vector<TraceStreamEntry> entries(per_thread.size());
+        std::size_t offset = align64(sizeof(header) + entries.size() * sizeof(TraceStreamEntry));
+        for (std::size_t t = 0; t < per_thread.size(); t++) {
+            entries[t].offset = offset;
+            entries[t].count = per_thread[t].size();
+            offset = align64(offset + per_thread[t].size() * sizeof(WorkloadOp));
+        }
+
+        static const char zeros[64] = {};
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  (entries.empty() ||
+                   fwrite(entries.data(), sizeof(TraceStreamEntry), entries.size(), file) ==
+                       entries.size());
+        std::size_t written = sizeof(header) + entries.size() * sizeof(TraceStreamEntry);
+        for (std::size_t t = 0; ok && t < per_thread.size(); t++) {
+            std::size_t padding = entries[t].offset - written;
+            const std::vector<WorkloadOp>& ops = per_thread[t];
+            ok = fwrite(zeros, 1, padding, file) == padding &&
+                 (ops.empty() || fwrite(ops.data(), sizeof(WorkloadOp), ops.size(), file) == ops.size());
+            written = entries[t].offset + ops.size() * sizeof(WorkloadOp);
+        }
+        if (fclose(file) != 0) ok = false;
+        if (!ok) *error = std::string("error de escritura: ") + strerror(errno);
+        return ok;
+    }
+
+    /**
+     * Mapear y validar una traza
+     * @return: false (y *error) si el archivo no es una traza válida
+     */
+    bool load(const char* path, std::string* error) {
+        unmap();
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            *error = std::string("no se pudo abrir: ") + strerror(errno);
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (std::size_t)st.st_size < sizeof(TraceHeader)) {
+            close(fd);
+            *error = "archivo demasiado corto";
+            return false;
+        }
+        bytes = (std::size_t)st.st_size;
+        base = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED) {
+            base = nullptr;
+            bytes = 0;
+            *error = std::string("mmap falló: ") + strerror(errno);
+            return false;
+        }
+
+        const char* data = static_cast<const char*>(base);
+        const TraceHeader* header = reinterpret_cast<const TraceHeader*>(data);
+        std::size_t table_end = sizeof(TraceHeader) +
+                                (std::size_t)header->num_threads * sizeof(TraceStreamEntry);
+        if (memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+            header->version != TRACE_VERSION || header->record_size != sizeof(WorkloadOp) ||
+            header->num_threads == 0 || table_end > bytes) {
+            unmap();
+            *error = "encabezado inválido (magic, versión, tamaño de registro o hilos)";
+            return false;
+        }
+
+        const TraceStreamEntry* entries =
+            reinterpret_cast<const TraceStreamEntry*>(data + sizeof(TraceHeader));
+        for (uint32_t t = 0; t < header->num_threads; t++) {
+            uint64_t offset = entries[t].offset;
+            uint64_t count = entries[t].count;
+            if (offset % alignof(WorkloadOp) != 0 || offset < table_end || offset > bytes ||
+                count > (bytes - offset) / sizeof(WorkloadOp)) {
+                unmap();
+                *error = "flujo de hilo fuera del archivo";
+                return false;
+            }
+            const WorkloadOp* ops = reinterpret_cast<const WorkloadOp*>(data + offset);
+            for (uint64_t i = 0; i < count; i++) {
+                if (ops[i].kind > OP_REMOVE) {
+                    unmap();
+                    *error = "registro con operación desconocida";
+                    return false;
+                }
+            }
+            streams.push_back({ops, (long)count});
+        }
+        return true;
+    }
+
+    int num_threads() const { return (int)streams.size(); }
+    const std::vector<OpStream>& thread_streams() const { return streams; }
+
+    long total_ops() const {
+        long total = 0;
+        for (const OpStream& stream : streams) total += stream.count;
+        return total;
+    }
+};
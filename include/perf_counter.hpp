@@ -0,0 +1,105 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Contadores de Hardware con perf_event_open
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Contar eventos del procesador (fallos de LLC) alrededor de una
+ *           región de código del propio proceso, sin herramientas externas
+ */
+
+#pragma once
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+// ============================================================================
+// CLASE PERFCOUNTER
+// ============================================================================
+
+/**
+ * Un contador de hardware para el hilo que lo abre (cualquier CPU), solo
+ * modo usuario: funciona con perf_event_paranoid <= 2 sin privilegios
+ *
+ * Si el kernel o la máquina virtual no exponen la PMU, open_*() devuelve
+ * false y error() explica por qué: el llamador reporta "n/d" y sigue.
+ */
+class PerfCounter {
+private:
+    int fd = -1;
+    int last_errno = 0;
+    const char* event_name = "";
+
+    bool open_event(uint32_t type, uint64_t config, const char* name) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        int new_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (new_fd < 0) {
+            last_errno = errno;
+            return false;
+        }
+        close_fd();
+        fd = new_fd;
+        event_name = name;
+        return true;
+    }
+
+    void close_fd() {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+public:
+    PerfCounter() = default;
+    ~PerfCounter() { close_fd(); }
+
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    /**
+     * Fallos de lectura en el último nivel de caché; si el evento genérico
+     * de caché no existe, se usa PERF_COUNT_HW_CACHE_MISSES (en x86 también
+     * cuenta referencias a LLC que fallan)
+     */
+    bool open_llc_misses() {
+        const uint64_t ll_read_miss = PERF_COUNT_HW_CACHE_LL |
+                                      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        return open_event(PERF_TYPE_HW_CACHE, ll_read_miss, "LLC read misses") ||
+               open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache misses");
+    }
+
+    bool available() const { return fd >= 0; }
+    const char* name() const { return event_name; }
+    const char* error() const { return last_errno ? strerror(last_errno) : "sin abrir"; }
+
+    void start() {
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    /**
+     * Detener y devolver la cuenta desde start() (0 si no está disponible)
+     */
+    uint64_t stop() {
+        if (fd < 0) return 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t count = 0;
+        if (read(fd, &count, sizeof(count)) != (ssize_t)sizeof(count)) return 0;
+        return count;
+    }
+};
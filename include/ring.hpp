@@ -0,0 +1,612 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Anillo Genérico SPSC con Slots Sin Copia
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Cola de un productor y un consumidor para cualquier tipo T
+ *           (incluidos tipos solo-movibles), con construcción en el slot
+ *           (emplace) y API claim/commit + front/release para no copiar
+ *           registros grandes al entrar ni al salir. Cada lado bloquea
+ *           hasta que el otro le avise (condvar, o eventfd integrable con
+ *           epoll para el consumidor)
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "cacheline.hpp"
+#include "huge_pages.hpp"
+#include "timing.hpp"
+
+// ============================================================================
+// CLASE RING<T>
+// ============================================================================
+
+/**
+ * Contadores del anillo (leer solo cuando ambos lados terminaron)
+ */
+struct RingStats {
+    long produced = 0;
+    long consumed = 0;
+    long producer_waits = 0;   // Veces que el productor encontró la cola llena
+    long consumer_waits = 0;   // Veces que el consumidor encontró la cola vacía
+    long consumer_sleeps = 0;  // Veces que el consumidor se declaró dormido
+    long notify_writes = 0;    // Avisos del productor (write() al eventfd o signal)
+    long producer_sleeps = 0;  // Veces que el productor se declaró dormido (cola llena)
+    long space_notifies = 0;   // Avisos de espacio del consumidor (signal)
+    std::size_t size = 0;      // Elementos que quedaron en la cola
+};
+
+/**
+ * Anillo de un solo productor y un solo consumidor sin mutex
+ *
+ * - head solo lo escribe el productor y tail solo el consumidor; cada uno
+ *   vive en su propia línea de caché para que no haya false sharing
+ * - Los índices crecen sin límite; la posición es (índice & mask) y la
+ *   ocupación es head - tail (correcto aun con desbordamiento de size_t)
+ * - Publicación: el productor construye el elemento y luego escribe head con
+ *   release; el consumidor lee head con acquire antes de tocar el slot (y
+ *   simétrico para liberar espacio con tail)
+ * - Cada lado guarda una copia del índice contrario y solo vuelve a leer la
+ *   línea del otro cuando la copia dice lleno/vacío
+ *
+ * Sin copias:
+ *   Productor: claim(args...) construye T dentro del slot y devuelve el
+ *              puntero para terminar de llenarlo; commit() lo publica
+ *   Consumidor: front() da el elemento dentro del slot; release() lo destruye
+ *               y devuelve el slot al productor
+ * emplace/push/pop son atajos sobre estas dos parejas.
+ *
+ * slot_bytes (>= sizeof(T)) deja bytes libres después de T en cada slot para
+ * registros de largo variable: T es la cabecera y la carga útil sigue en el
+ * mismo slot (se escribe entre claim y commit, se lee entre front y release).
+ *
+ * Las esperas giran, luego ceden el núcleo y al final bloquean hasta el
+ * aviso del otro lado: una etapa ociosa no acapara la CPU y despierta en
+ * cuanto hay datos (commit avisa al consumidor) o espacio (release avisa
+ * al productor), sin la granularidad de un sleep.
+ *
+ * Aviso coalescido:
+ *   Para no pagar una syscall por elemento, el lado que espera se declara
+ *   dormido, vuelve a revisar la cola y recién entonces bloquea; el otro
+ *   lado, tras publicar head o tail, solo avisa si ve la declaración y es
+ *   el primero en retirarla. Con carga alta casi nadie duerme y no hay
+ *   syscalls en el camino caliente. La declaración y el índice se ordenan
+ *   con barreras seq_cst en ambos lados (patrón de Dekker) para que no se
+ *   pierda un aviso. Por defecto ambos lados bloquean en una condvar
+ *   (park, pthread_cond_signal).
+ *
+ * Aviso por eventfd (enable_eventfd):
+ *   El consumidor duerme en notify_fd() con poll/epoll junto a sockets o
+ *   timers (prepare_sleep / finish_sleep) y el productor escribe al eventfd
+ *   en vez de señalar la condvar. El productor sigue esperando espacio en
+ *   su condvar.
+ */
+template<typename T>
+class Ring {
+    static_assert(alignof(T) <= CACHE_LINE_SIZE, "Ring<T>: alineación mayor a una línea de caché");
+
+public:
+    static constexpr uint64_t NO_TIMEOUT = UINT64_MAX;
+    static constexpr int SPIN_ITERS = 64;      // Reintentos con pause
+    static constexpr int YIELD_ITERS = 256;    // Reintentos con sched_yield
+
+private:
+    // Solo lectura tras init (compartida por ambos lados sin rebotar)
+    alignas(CACHE_LINE_SIZE) unsigned char* buffer = nullptr;
+    std::size_t slot_capacity = 0;
+    std::size_t mask = 0;
+    std::size_t stride = 0;
+    HugeBuffer storage;
+
+    // Línea del productor
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head{0};
+
+    // Privado del productor (no lo lee el consumidor)
+    alignas(CACHE_LINE_SIZE) std::size_t cached_tail = 0;
+    long producer_waits = 0;
+    long producer_sleeps = 0;
+    long notify_writes = 0;
+
+    // Línea del consumidor
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail{0};
+
+    // Privado del consumidor
+    alignas(CACHE_LINE_SIZE) std::size_t cached_head = 0;
+    long consumer_waits = 0;
+    long consumer_sleeps = 0;
+    long space_notifies = 0;
+
+    // Control de terminación (solo se escribe una vez por corrida)
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> closed_flag{false};
+
+    /**
+     * Un lado que espera: el otro lee sleeping tras cada publicación y solo
+     * hay tráfico en esta línea cuando el que espera de verdad duerme
+     */
+    struct alignas(CACHE_LINE_SIZE) Waiter {
+        std::atomic<bool> sleeping{false};
+        bool signaled = false;   // Protegido por mutex
+        pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+        pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+    };
+
+    Waiter data_waiter;    // Consumidor esperando datos
+    Waiter space_waiter;   // Productor esperando espacio
+    int event_fd = -1;     // Con enable_eventfd, reemplaza la condvar de data_waiter
+
+    T* slot(std::size_t index) const {
+        return reinterpret_cast<T*>(buffer + (index & mask) * stride);
+    }
+
+    bool has_space() {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h - cached_tail < slot_capacity) return true;
+        cached_tail = tail.load(std::memory_order_acquire);
+        return h - cached_tail < slot_capacity;
+    }
+
+    bool has_data() {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t != cached_head) return true;
+        cached_head = head.load(std::memory_order_acquire);
+        return t != cached_head;
+    }
+
+    /**
+     * Girar y luego ceder el núcleo hasta que ready()
+     * @return: false si se agotaron los reintentos
+     */
+    template<typename Ready>
+    static bool spin_then_yield(Ready& ready) {
+        for (int i = 0; i < SPIN_ITERS; i++) {
+            if (ready()) return true;
+            cpu_relax();
+        }
+        for (int i = 0; i < YIELD_ITERS; i++) {
+            if (ready()) return true;
+            sched_yield();
+        }
+        return false;
+    }
+
+    /**
+     * Girar, ceder y luego bloquear (sleep_once) hasta que ready() o se
+     * agote el plazo. sleep_once recibe los ns que quedan (o NO_TIMEOUT)
+     * @return: false si venció el plazo
+     */
+    template<typename Ready, typename Sleep>
+    static bool wait_blocking(Ready ready, Sleep sleep_once, uint64_t timeout_ns) {
+        if (spin_then_yield(ready)) return true;
+        uint64_t deadline = timeout_ns == NO_TIMEOUT ? NO_TIMEOUT : now_ns() + timeout_ns;
+        for (;;) {
+            if (ready()) return true;
+            uint64_t remaining_ns = NO_TIMEOUT;
+            if (deadline != NO_TIMEOUT) {
+                uint64_t now = now_ns();
+                if (now >= deadline) return false;
+                remaining_ns = deadline - now;
+            }
+            sleep_once(remaining_ns);
+        }
+    }
+
+    /**
+     * Bloquear en la condvar del lado hasta su aviso o timeout_ns
+     */
+    static void park_on(Waiter& waiter, uint64_t timeout_ns) {
+        pthread_mutex_lock(&waiter.mutex);
+        if (timeout_ns == NO_TIMEOUT) {
+            while (!waiter.signaled) pthread_cond_wait(&waiter.cond, &waiter.mutex);
+        } else {
+            uint64_t deadline = now_ns() + timeout_ns;
+            timespec ts{(time_t)(deadline / 1000000000ull), (long)(deadline % 1000000000ull)};
+            while (!waiter.signaled &&
+                   pthread_cond_timedwait(&waiter.cond, &waiter.mutex, &ts) != ETIMEDOUT) {
+            }
+        }
+        waiter.signaled = false;   // Consumir el aviso (como leer el eventfd)
+        pthread_mutex_unlock(&waiter.mutex);
+    }
+
+    static void signal_waiter(Waiter& waiter) {
+        pthread_mutex_lock(&waiter.mutex);
+        waiter.signaled = true;
+        pthread_cond_signal(&waiter.cond);
+        pthread_mutex_unlock(&waiter.mutex);
+    }
+
+    /**
+     * Retirar la declaración de sleeping si sigue puesta (lado que avisa)
+     * @return: true si hay que despertar al otro lado
+     */
+    static bool claim_wakeup(Waiter& waiter) {
+        // Ordena el índice (ya publicado) antes de leer sleeping; pareja de
+        // la barrera de quien se declara dormido
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return waiter.sleeping.load(std::memory_order_relaxed) &&
+               waiter.sleeping.exchange(false, std::memory_order_acq_rel);
+    }
+
+    /**
+     * Reloj monótono para los plazos de park_on(), como now_ns()
+     */
+    static void init_waiter(Waiter& waiter) {
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_destroy(&waiter.cond);   // Reemplazar el inicializador estático
+        pthread_cond_init(&waiter.cond, &attr);
+        pthread_condattr_destroy(&attr);
+    }
+
+    static void destroy_waiter(Waiter& waiter) {
+        pthread_cond_destroy(&waiter.cond);
+        pthread_mutex_destroy(&waiter.mutex);
+    }
+
+    /**
+     * Aviso coalescido tras publicar head (lado productor)
+     */
+    void notify_consumer() {
+        if (claim_wakeup(data_waiter)) {
+            wake_consumer();
+            notify_writes++;
+        }
+    }
+
+    void wake_consumer() {
+        if (event_fd >= 0) {
+            uint64_t one = 1;
+            ssize_t written = write(event_fd, &one, sizeof(one));
+            (void)written;  // EAGAIN solo si el contador se satura: ya hay aviso pendiente
+        } else {
+            signal_waiter(data_waiter);
+        }
+    }
+
+    /**
+     * Aviso coalescido tras liberar un slot (lado consumidor)
+     */
+    void notify_producer() {
+        if (claim_wakeup(space_waiter)) {
+            signal_waiter(space_waiter);
+            space_notifies++;
+        }
+    }
+
+    /**
+     * Declararse dormido esperando espacio (lado productor)
+     * @return: false si ya hay espacio o la cola está cerrada (no bloquear)
+     */
+    bool prepare_space_sleep() {
+        space_waiter.sleeping.store(true, std::memory_order_relaxed);
+        // Ordena la declaración antes de volver a leer tail; pareja de la
+        // barrera en notify_producer
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (has_space() || closed_flag.load(std::memory_order_acquire)) {
+            space_waiter.sleeping.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        producer_sleeps++;
+        return true;
+    }
+
+    void destroy_pending() {
+        if (!std::is_trivially_destructible<T>::value) {
+            for (std::size_t i = tail.load(); i != head.load(); i++) {
+                slot(i)->~T();
+            }
+        }
+    }
+
+public:
+    Ring() {
+        init_waiter(data_waiter);
+        init_waiter(space_waiter);
+    }
+
+    Ring(std::size_t capacity, bool huge_pages = false, std::size_t slot_bytes = sizeof(T))
+        : Ring() {
+        init(capacity, huge_pages, slot_bytes);
+    }
+
+    ~Ring() {
+        destroy_pending();
+        if (event_fd >= 0) ::close(event_fd);
+        destroy_waiter(data_waiter);
+        destroy_waiter(space_waiter);
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    /**
+     * Reservar los slots (descarta lo que hubiera y reabre la cola)
+     * La capacidad se redondea a potencia de 2 (mínimo 2)
+     * @return: false si no hubo memoria
+     */
+    bool init(std::size_t capacity, bool huge_pages = false, std::size_t slot_bytes = sizeof(T)) {
+        destroy_pending();
+        slot_capacity = round_up_pow2(capacity < 2 ? 2 : capacity);
+        mask = slot_capacity - 1;
+        stride = round_up(slot_bytes < sizeof(T) ? sizeof(T) : slot_bytes, alignof(T));
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        cached_tail = cached_head = 0;
+        producer_waits = consumer_waits = consumer_sleeps = notify_writes = 0;
+        producer_sleeps = space_notifies = 0;
+        closed_flag.store(false, std::memory_order_relaxed);
+        for (Waiter* waiter : {&data_waiter, &space_waiter}) {
+            waiter->sleeping.store(false, std::memory_order_relaxed);
+            waiter->signaled = false;
+        }
+        if (event_fd >= 0) {
+            uint64_t count;
+            ssize_t got = read(event_fd, &count, sizeof(count));  // Aviso viejo
+            (void)got;
+        }
+        if (!storage.allocate(slot_capacity * stride, huge_pages)) {
+            buffer = nullptr;
+            return false;
+        }
+        buffer = static_cast<unsigned char*>(storage.data());
+        return true;
+    }
+
+    // ------------------------------------------------------------------------
+    // Productor
+    // ------------------------------------------------------------------------
+
+    /**
+     * Construir T en el siguiente slot libre sin publicarlo (wait-free)
+     * @return: puntero al elemento, o nullptr si la cola está llena
+     */
+    template<typename... Args>
+    T* try_claim(Args&&... args) {
+        if (!has_space()) return nullptr;
+        void* place = slot(head.load(std::memory_order_relaxed));
+        return new (place) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Como try_claim, esperando espacio hasta timeout_ns
+     * @return: nullptr si venció el plazo o la cola se cerró
+     */
+    template<typename... Args>
+    T* claim_for(uint64_t timeout_ns, Args&&... args) {
+        if (!has_space()) {
+            producer_waits++;
+            bool ready = wait_blocking([this] {
+                return closed_flag.load(std::memory_order_acquire) || has_space();
+            }, [this](uint64_t remaining_ns) {
+                if (prepare_space_sleep()) {
+                    park_on(space_waiter, remaining_ns);
+                    space_waiter.sleeping.store(false, std::memory_order_relaxed);
+                }
+            }, timeout_ns);
+            if (!ready || closed_flag.load(std::memory_order_acquire)) return nullptr;
+        }
+        return try_claim(std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    T* claim(Args&&... args) {
+        return claim_for(NO_TIMEOUT, std::forward<Args>(args)...);
+    }
+
+    /**
+     * Publicar el slot obtenido con claim (el consumidor ya puede verlo)
+     */
+    void commit() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        notify_consumer();
+    }
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        if (!try_claim(std::forward<Args>(args)...)) return false;
+        commit();
+        return true;
+    }
+
+    template<typename... Args>
+    bool emplace(Args&&... args) {
+        if (!claim(std::forward<Args>(args)...)) return false;
+        commit();
+        return true;
+    }
+
+    bool try_push(const T& value) { return try_emplace(value); }
+    bool try_push(T&& value) { return try_emplace(std::move(value)); }
+    bool push(const T& value) { return emplace(value); }
+    bool push(T&& value) { return emplace(std::move(value)); }
+
+    /**
+     * Cerrar la cola: claim falla desde ahora y front sigue entregando lo
+     * pendiente hasta vaciarla (shutdown sin perder elementos)
+     */
+    void close() {
+        closed_flag.store(true, std::memory_order_release);
+        // Despertar siempre a ambos lados: deben ver el cierre aunque no
+        // haya elementos ni espacio nuevos
+        data_waiter.sleeping.store(false, std::memory_order_relaxed);
+        wake_consumer();
+        space_waiter.sleeping.store(false, std::memory_order_relaxed);
+        signal_waiter(space_waiter);
+    }
+
+    // ------------------------------------------------------------------------
+    // Aviso por eventfd
+    // ------------------------------------------------------------------------
+
+    /**
+     * Activar el aviso por eventfd (antes de que arranquen los hilos)
+     * Desde aquí front()/pop() bloquean en el eventfd en vez de la condvar,
+     * y notify_fd() se puede registrar en un epoll
+     * @return: false si no se pudo crear el eventfd
+     */
+    bool enable_eventfd() {
+        if (event_fd >= 0) return true;
+        event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        return event_fd >= 0;
+    }
+
+    int notify_fd() const { return event_fd; }
+
+    /**
+     * Bloquear en la condvar hasta el aviso del productor o timeout_ns
+     * (sin eventfd, entre prepare_sleep() == true y finish_sleep())
+     */
+    void park(uint64_t timeout_ns = NO_TIMEOUT) {
+        park_on(data_waiter, timeout_ns);
+    }
+
+    /**
+     * Declararse dormido antes de bloquear en notify_fd() o park() (lado consumidor)
+     * @return: false si ya hay datos o la cola está cerrada (no bloquear)
+     */
+    bool prepare_sleep() {
+        data_waiter.sleeping.store(true, std::memory_order_relaxed);
+        // Ordena la declaración antes de volver a leer head; pareja de la
+        // barrera en notify_consumer
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (has_data() || closed_flag.load(std::memory_order_acquire)) {
+            data_waiter.sleeping.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        consumer_sleeps++;
+        return true;
+    }
+
+    /**
+     * Tras despertar (o al rendirse por timeout): retirar la declaración y
+     * consumir el contador del eventfd
+     */
+    void finish_sleep() {
+        data_waiter.sleeping.store(false, std::memory_order_relaxed);
+        if (event_fd < 0) return;   // park() ya consumió el aviso
+        uint64_t count;
+        ssize_t got = read(event_fd, &count, sizeof(count));
+        (void)got;  // EAGAIN: nadie escribió (timeout o despertar espurio)
+    }
+
+    // ------------------------------------------------------------------------
+    // Consumidor
+    // ------------------------------------------------------------------------
+
+    /**
+     * Elemento más antiguo, leído dentro de su slot (wait-free)
+     * @return: nullptr si la cola está vacía
+     */
+    T* try_front() {
+        if (!has_data()) return nullptr;
+        return slot(tail.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * Como try_front, esperando datos hasta timeout_ns
+     * @return: nullptr si venció el plazo, o si la cola se cerró y está vacía
+     */
+    T* front_for(uint64_t timeout_ns) {
+        if (has_data()) return try_front();
+
+        consumer_waits++;
+        bool drained = false;
+        auto ready_or_drained = [this, &drained] {
+            // Leer la bandera ANTES de reintentar: si ya estaba puesta y el
+            // reintento falla, el productor no publicará nada más
+            bool closing = closed_flag.load(std::memory_order_acquire);
+            if (has_data()) return true;
+            drained = closing;
+            return closing;
+        };
+        bool ready = wait_blocking(ready_or_drained, [this](uint64_t remaining_ns) {
+            if (prepare_sleep()) {
+                if (event_fd >= 0) {
+                    int poll_ms = remaining_ns == NO_TIMEOUT
+                                      ? -1 : (int)((remaining_ns + 999999) / 1000000);
+                    pollfd pfd{event_fd, POLLIN, 0};
+                    poll(&pfd, 1, poll_ms);
+                } else {
+                    park(remaining_ns);
+                }
+                finish_sleep();
+            }
+        }, timeout_ns);
+        if (!ready || drained) return nullptr;
+        return try_front();
+    }
+
+    T* front() {
+        return front_for(NO_TIMEOUT);
+    }
+
+    /**
+     * Destruir el elemento de front() y devolver su slot al productor
+     */
+    void release() {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        slot(t)->~T();
+        tail.store(t + 1, std::memory_order_release);
+        notify_producer();
+    }
+
+    bool try_pop(T& output) {
+        T* item = try_front();
+        if (!item) return false;
+        output = std::move(*item);
+        release();
+        return true;
+    }
+
+    bool pop(T& output) {
+        T* item = front();
+        if (!item) return false;
+        output = std::move(*item);
+        release();
+        return true;
+    }
+
+    // ------------------------------------------------------------------------
+    // Consultas
+    // ------------------------------------------------------------------------
+
+    std::size_t capacity() const { return slot_capacity; }
+    std::size_t slot_bytes() const { return stride; }
+    bool closed() const { return closed_flag.load(std::memory_order_acquire); }
+    const HugeBuffer& memory() const { return storage; }
+
+    std::size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    RingStats stats() const {
+        RingStats s;
+        s.produced = (long)head.load(std::memory_order_acquire);
+        s.consumed = (long)tail.load(std::memory_order_acquire);
+        s.producer_waits = producer_waits;
+        s.consumer_waits = consumer_waits;
+        s.consumer_sleeps = consumer_sleeps;
+        s.notify_writes = notify_writes;
+        s.producer_sleeps = producer_sleeps;
+        s.space_notifies = space_notifies;
+        s.size = (std::size_t)(s.produced - s.consumed);
+        return s;
+    }
+};
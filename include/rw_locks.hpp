@@ -0,0 +1,263 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Familia de Locks Lector/Escritor
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Locks lector/escritor intercambiables con distintas políticas
+ *           de equidad (preferir lectores, preferir escritores, fases
+ *           alternadas, lectores distribuidos) para comparar el hambre de
+ *           escritores y el costo de los lectores
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <cstdint>
+#include "cacheline.hpp"
+#include "thread_index.hpp"
+
+// ============================================================================
+// INTERFAZ COMÚN
+// ============================================================================
+
+/**
+ * Todos los locks exponen:
+ *   lock() / unlock() / try_lock()                          escritura
+ *   lock_shared() / unlock_shared() / try_lock_shared()     lectura
+ * y NAME para los reportes. try_* no espera: false si tendría que bloquear.
+ * Los locks de espera activa ceden el núcleo tras unos reintentos para no
+ * quitarle la CPU al dueño (relevante con más hilos que núcleos)
+ */
+inline void rw_spin_pause(int* spins) {
+    if (++*spins < 64) {
+        cpu_relax();
+    } else {
+        sched_yield();
+    }
+}
+
+// ============================================================================
+// PTHREAD_RWLOCK_T
+// ============================================================================
+
+/**
+ * pthread_rwlock_t con atributos por defecto: en glibc prefiere lectores,
+ * así que con lectores solapados un escritor puede esperar indefinidamente
+ */
+struct PthreadRWLock {
+    static constexpr const char* NAME = "pthread (prefiere lectores)";
+    pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+
+    PthreadRWLock() = default;
+    PthreadRWLock(const PthreadRWLock&) = delete;
+    PthreadRWLock& operator=(const PthreadRWLock&) = delete;
+    ~PthreadRWLock() { pthread_rwlock_destroy(&rwlock); }
+
+    void lock() { pthread_rwlock_wrlock(&rwlock); }
+    void unlock() { pthread_rwlock_unlock(&rwlock); }
+    bool try_lock() { return pthread_rwlock_trywrlock(&rwlock) == 0; }
+    void lock_shared() { pthread_rwlock_rdlock(&rwlock); }
+    void unlock_shared() { pthread_rwlock_unlock(&rwlock); }
+    bool try_lock_shared() { return pthread_rwlock_tryrdlock(&rwlock) == 0; }
+};
+
+/**
+ * pthread_rwlock_t que prefiere escritores (extensión de glibc): con un
+ * escritor esperando, los lectores nuevos esperan también. La variante
+ * NONRECURSIVE es la única que glibc respeta (prohíbe rdlock recursivo);
+ * fuera de glibc se queda con el comportamiento por defecto
+ */
+struct PthreadWriterPrefRWLock : PthreadRWLock {
+    static constexpr const char* NAME = "pthread (prefiere escritores)";
+
+    PthreadWriterPrefRWLock() {
+#if defined(__GLIBC__)
+        pthread_rwlockattr_t attr;
+        pthread_rwlockattr_init(&attr);
+        pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+        pthread_rwlock_destroy(&rwlock);   // Reemplazar el inicializador estático
+        pthread_rwlock_init(&rwlock, &attr);
+        pthread_rwlockattr_destroy(&attr);
+#endif
+    }
+};
+
+// ============================================================================
+// PHASE-FAIR TICKET LOCK
+// ============================================================================
+
+/**
+ * Lock lector/escritor de fases equitativas con tickets (PF-T, Brandenburg
+ * y Anderson)
+ *
+ * - Escritores en orden FIFO por ticket (win / wout)
+ * - rin cuenta lectores que entraron (de RINC en RINC) y en sus 2 bits bajos
+ *   marca un escritor presente (PRES) y la paridad de su ticket (PHID);
+ *   rout cuenta lectores que salieron
+ * - Un lector que ve PRES espera solo a que cambien esos bits, es decir, a
+ *   que termine UNA fase de escritura; un escritor espera solo a los
+ *   lectores que ya estaban dentro. Fases de lectura y escritura se
+ *   alternan: ningún lado puede matar de hambre al otro y la espera de un
+ *   lector está acotada por una sección crítica de escritura
+ */
+class PhaseFairRWLock {
+private:
+    static constexpr uint32_t RINC = 0x100;   // Incremento de lector
+    static constexpr uint32_t WBITS = 0x3;    // Bits de escritor en rin
+    static constexpr uint32_t PRES = 0x2;     // Hay un escritor presente
+    static constexpr uint32_t PHID = 0x1;     // Paridad de la fase
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> rin{0};
+    std::atomic<uint32_t> rout{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> win{0};
+    std::atomic<uint32_t> wout{0};
+
+    // Con el ticket de escritor ya servido: cerrar la entrada y esperar a
+    // los lectores de dentro. Devuelve rin anterior (solo lectores)
+    uint32_t close_readers(uint32_t ticket) {
+        return rin.fetch_add(PRES | (ticket & PHID), std::memory_order_acq_rel);
+    }
+
+public:
+    static constexpr const char* NAME = "phase-fair (tickets)";
+
+    void lock_shared() {
+        uint32_t w = rin.fetch_add(RINC, std::memory_order_acq_rel) & WBITS;
+        if (w == 0) return;
+        for (int spins = 0; (rin.load(std::memory_order_acquire) & WBITS) == w;) {
+            rw_spin_pause(&spins);
+        }
+    }
+
+    void unlock_shared() { rout.fetch_add(RINC, std::memory_order_release); }
+
+    bool try_lock_shared() {
+        uint32_t current = rin.load(std::memory_order_relaxed);
+        while ((current & WBITS) == 0) {
+            if (rin.compare_exchange_weak(current, current + RINC, std::memory_order_acq_rel)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void lock() {
+        uint32_t ticket = win.fetch_add(1, std::memory_order_relaxed);
+        for (int spins = 0; wout.load(std::memory_order_acquire) != ticket;) {
+            rw_spin_pause(&spins);
+        }
+        uint32_t readers_in = close_readers(ticket);
+        for (int spins = 0; rout.load(std::memory_order_acquire) != readers_in;) {
+            rw_spin_pause(&spins);
+        }
+    }
+
+    void unlock() {
+        rin.fetch_and(~WBITS, std::memory_order_release);   // Liberar a los lectores
+        wout.fetch_add(1, std::memory_order_release);       // Siguiente escritor
+    }
+
+    bool try_lock() {
+        uint32_t ticket = wout.load(std::memory_order_acquire);
+        if (win.load(std::memory_order_relaxed) != ticket ||
+            (rin.load(std::memory_order_relaxed) & ~WBITS) != rout.load(std::memory_order_relaxed) ||
+            !win.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acq_rel)) {
+            return false;
+        }
+        // Un lector pudo entrar entre la revisión y el cierre: devolver la fase
+        if (close_readers(ticket) != rout.load(std::memory_order_acquire)) {
+            unlock();
+            return false;
+        }
+        return true;
+    }
+};
+
+// ============================================================================
+// BIG-READER LOCK (LECTORES DISTRIBUIDOS)
+// ============================================================================
+
+/**
+ * Lock de "lectores grandes": cada hilo marca su lectura en su propio slot
+ * (una línea de caché por thread_index()), así que los lectores nunca
+ * escriben una línea compartida; el escritor paga recorriendo los slots
+ *
+ * Protocolo (tipo Dekker, todo seq_cst):
+ *   lector:   slot = 1; si writer → slot = 0, esperar y reintentar
+ *   escritor: writer = 1 (exclusivo entre escritores); esperar slot == 0
+ *             en los índices < thread_index_limit()
+ * Si el escritor no ve el slot de un lector, ese lector sí ve writer y se
+ * retira. Prefiere escritores: con writer puesto no entran lectores nuevos.
+ * El slot es un indicador, no un contador: no admite lecturas anidadas
+ *
+ * Los slots son por hilo y no por CPU: con un slot por CPU el hilo puede
+ * migrar entre lock_shared() y unlock_shared() y el slot necesitaría
+ * operaciones atómicas de lectura-modificación-escritura compartidas entre
+ * los hilos de ese núcleo
+ */
+class BigReaderRWLock {
+private:
+    struct alignas(CACHE_LINE_SIZE) ReaderSlot {
+        std::atomic<int> active{0};
+    };
+
+    ReaderSlot slots[MAX_THREAD_INDEX];
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> writer{false};
+
+    bool readers_gone() const {
+        int limit = thread_index_limit();
+        for (int i = 0; i < limit; i++) {
+            if (slots[i].active.load()) return false;
+        }
+        return true;
+    }
+
+public:
+    static constexpr const char* NAME = "big-reader (slots por hilo)";
+
+    void lock_shared() {
+        std::atomic<int>& active = slots[thread_index()].active;
+        for (;;) {
+            active.store(1);
+            if (!writer.load()) return;
+            active.store(0, std::memory_order_release);
+            for (int spins = 0; writer.load(std::memory_order_relaxed);) {
+                rw_spin_pause(&spins);
+            }
+        }
+    }
+
+    void unlock_shared() {
+        slots[thread_index()].active.store(0, std::memory_order_release);
+    }
+
+    bool try_lock_shared() {
+        std::atomic<int>& active = slots[thread_index()].active;
+        active.store(1);
+        if (!writer.load()) return true;
+        active.store(0, std::memory_order_release);
+        return false;
+    }
+
+    void lock() {
+        for (int spins = 0; writer.load(std::memory_order_relaxed) || writer.exchange(true);) {
+            rw_spin_pause(&spins);
+        }
+        for (int spins = 0; !readers_gone();) {
+            rw_spin_pause(&spins);
+        }
+    }
+
+    void unlock() { writer.store(false, std::memory_order_release); }
+
+    bool try_lock() {
+        if (writer.load(std::memory_order_relaxed) || writer.exchange(true)) return false;
+        if (readers_gone()) return true;
+        writer.store(false, std::memory_order_release);
+        return false;
+    }
+};
@@ -0,0 +1,157 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Contador Particionado Reutilizable
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Contador concurrente con un slot alineado a línea de caché por
+ *           hilo, escritura sin locks y lectura mientras los escritores corren
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include "cacheline.hpp"
+
+// ============================================================================
+// CLASE SHARDEDCOUNTER
+// ============================================================================
+
+/**
+ * Resultado de ShardedCounter::read_exact()
+ */
+struct CounterSnapshot {
+    long value = 0;      // Valor que el contador tuvo en algún instante
+    int attempts = 0;    // Dobles recolecciones hechas en esta llamada
+    bool fresh = false;  // true: instante dentro de la llamada; false: el de
+                         // la última lectura consistente (los escritores
+                         // invalidaron todos los intentos)
+};
+
+/**
+ * Contador particionado en N slots, cada uno en su propia línea de caché
+ *
+ * - add(): fetch_add relaxed sobre el slot del hilo. El slot casi nunca se
+ *   comparte, así que la línea permanece en la caché del núcleo que escribe
+ * - read_approx(): suma relaxed de todos los slots, sin coordinación
+ * - read_exact(): valor que el contador tuvo realmente en algún instante
+ *   (válido mientras solo se sumen deltas positivos), sin frenar nunca a
+ *   los escritores
+ *
+ * Cada hilo recibe un slot fijo por round-robin la primera vez que escribe.
+ * Se prefiere esto a sched_getcpu() porque el índice no cambia al migrar el
+ * hilo y no cuesta nada por operación. Con más hilos que N, varios hilos
+ * comparten slot; el fetch_add mantiene el resultado correcto.
+ */
+template<std::size_t N = 64>
+class ShardedCounter {
+    static_assert(N > 0, "ShardedCounter necesita al menos un slot");
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<long> value{0};
+    };
+
+    Slot slots[N];
+
+    // Última recolección estable (solo la escriben los lectores exactos)
+    alignas(CACHE_LINE_SIZE) std::atomic<long> last_consistent{0};
+
+    // Intentos de doble lectura por llamada a read_exact()
+    static constexpr int EXACT_RETRIES = 16;
+
+    static std::size_t thread_slot() {
+        static std::atomic<std::size_t> next_slot{0};
+        thread_local std::size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % N;
+        return slot;
+    }
+
+    long collect() const {
+        long sum = 0;
+        for (std::size_t i = 0; i < N; i++) {
+            sum += slots[i].value.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    bool stable_collect(long* total) const {
+        long first[N];
+        for (std::size_t i = 0; i < N; i++) {
+            first[i] = slots[i].value.load(std::memory_order_acquire);
+        }
+
+        long sum = 0;
+        for (std::size_t i = 0; i < N; i++) {
+            if (slots[i].value.load(std::memory_order_acquire) != first[i]) {
+                return false;
+            }
+            sum += first[i];
+        }
+        *total = sum;
+        return true;
+    }
+
+public:
+    ShardedCounter() = default;
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    /**
+     * Sumar delta al slot del hilo actual (sin locks)
+     */
+    void add(long delta = 1) {
+        slots[thread_slot()].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    /**
+     * Lectura aproximada: puede omitir incrementos en vuelo
+     * Costo: N cargas, nunca bloquea a los escritores
+     */
+    long read_approx() const {
+        return collect();
+    }
+
+    /**
+     * Lectura exacta con escritores activos
+     *
+     * Doble recolección: si dos pasadas consecutivas ven los mismos valores,
+     * todos los slots tuvieron esos valores al terminar la primera pasada.
+     * Si los escritores invalidan los EXACT_RETRIES intentos, devuelve la
+     * última recolección estable (exacta, pero de un instante anterior) con
+     * fresh = false: add() nunca espera a un lector
+     */
+    CounterSnapshot read_exact() {
+        CounterSnapshot snapshot;
+        long total = 0;
+        while (snapshot.attempts < EXACT_RETRIES) {
+            snapshot.attempts++;
+            if (stable_collect(&total)) {
+                // Conservar la mayor: otro lector pudo guardar una más reciente
+                long seen = last_consistent.load(std::memory_order_relaxed);
+                while (seen < total &&
+                       !last_consistent.compare_exchange_weak(seen, total,
+                                                              std::memory_order_relaxed)) {
+                }
+                snapshot.value = total;
+                snapshot.fresh = true;
+                return snapshot;
+            }
+        }
+        snapshot.value = last_consistent.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    /**
+     * Reiniciar a cero (solo sin escritores activos)
+     */
+    void reset() {
+        for (std::size_t i = 0; i < N; i++) {
+            slots[i].value.store(0, std::memory_order_relaxed);
+        }
+        last_consistent.store(0, std::memory_order_relaxed);
+    }
+
+    static constexpr std::size_t num_slots() { return N; }
+};
@@ -0,0 +1,418 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Afinidad de Hilos y Topología de CPU
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Fijar hilos a CPUs según una política de colocación para que
+ *           los benchmarks sean reproducibles en máquinas multi-socket
+ */
+
+#pragma once
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// ============================================================================
+// TOPOLOGÍA DE CPU (LEÍDA DE /sys)
+// ============================================================================
+
+struct CpuInfo {
+    int cpu;        // Número lógico de CPU
+    int socket;     // physical_package_id
+    int core;       // core_id dentro del socket
+    int sibling;    // Posición entre los hilos SMT del mismo núcleo (0 = primero)
+};
+
+/**
+ * Leer un entero de un archivo de /sys
+ */
+inline int read_sys_int(const char* path, int default_value) {
+    FILE* file = fopen(path, "r");
+    if (!file) return default_value;
+    int value = default_value;
+    if (fscanf(file, "%d", &value) != 1) value = default_value;
+    fclose(file);
+    return value;
+}
+
+/**
+ * Interpretar lista de CPUs en formato del kernel: "0-3,8,10-11"
+ */
+inline bool parse_cpu_list(const char* text, std::vector<int>* cpus) {
+    cpus->clear();
+    const char* p = text;
+    while (*p && *p != '\n') {
+        char* end;
+        long first = strtol(p, &end, 10);
+        if (end == p || first < 0) return false;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            if (end == p + 1 || last < first) return false;
+            p = end;
+        }
+        for (long c = first; c <= last; c++) cpus->push_back((int)c);
+        if (*p == ',') p++;
+        else if (*p && *p != '\n') return false;
+    }
+    return !cpus->empty();
+}
+
+/**
+ * Topología de las CPUs que este proceso puede usar
+ * Se construye una sola vez (primer uso) a partir de /sys/devices/system
+ */
+class CpuTopology {
+public:
+    std::vector<CpuInfo> cpus;   // CPUs permitidas, ordenadas por número
+    int num_sockets = 1;
+
+    static const CpuTopology& get() {
+        static const CpuTopology topology;
+        return topology;
+    }
+
+    bool has_cpu(int cpu) const {
+        for (const CpuInfo& info : cpus) {
+            if (info.cpu == cpu) return true;
+        }
+        return false;
+    }
+
+    /**
+     * CPUs de un socket en orden compacto: núcleo por núcleo, con los
+     * hermanos SMT adyacentes
+     */
+    std::vector<int> socket_cpus(int socket) const {
+        std::vector<CpuInfo> selected;
+        for (const CpuInfo& info : cpus) {
+            if (info.socket == socket) selected.push_back(info);
+        }
+        std::sort(selected.begin(), selected.end(), [](const CpuInfo& a, const CpuInfo& b) {
+            if (a.core != b.core) return a.core < b.core;
+            return a.cpu < b.cpu;
+        });
+        std::vector<int> result;
+        for (const CpuInfo& info : selected) result.push_back(info.cpu);
+        return result;
+    }
+
+    /**
+     * Orden compacto: llenar el socket 0 (hermanos SMT juntos), luego el 1...
+     */
+    std::vector<int> compact_order() const {
+        std::vector<int> order;
+        for (int s = 0; s < num_sockets; s++) {
+            std::vector<int> part = socket_cpus(s);
+            order.insert(order.end(), part.begin(), part.end());
+        }
+        return order;
+    }
+
+    /**
+     * Orden disperso: alternar sockets y ocupar un hilo por núcleo físico
+     * antes de usar los hermanos SMT
+     */
+    std::vector<int> scatter_order() const {
+        std::vector<std::vector<CpuInfo>> per_socket(num_sockets);
+        for (const CpuInfo& info : cpus) per_socket[info.socket].push_back(info);
+        for (auto& list : per_socket) {
+            std::sort(list.begin(), list.end(), [](const CpuInfo& a, const CpuInfo& b) {
+                if (a.sibling != b.sibling) return a.sibling < b.sibling;
+                if (a.core != b.core) return a.core < b.core;
+                return a.cpu < b.cpu;
+            });
+        }
+        std::vector<int> order;
+        for (std::size_t i = 0; order.size() < cpus.size(); i++) {
+            for (const auto& list : per_socket) {
+                if (i < list.size()) order.push_back(list[i].cpu);
+            }
+        }
+        return order;
+    }
+
+private:
+    CpuTopology() {
+        // CPUs en línea ∩ máscara de afinidad del proceso (cgroups/taskset)
+        std::vector<int> online;
+        char buffer[4096] = {0};
+        FILE* file = fopen("/sys/devices/system/cpu/online", "r");
+        if (file) {
+            if (!fgets(buffer, sizeof(buffer), file)) buffer[0] = '\0';
+            fclose(file);
+        }
+        if (!parse_cpu_list(buffer, &online)) {
+            online.clear();
+            for (int c = 0; c < CPU_SETSIZE; c++) online.push_back(c);
+        }
+
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+        for (int c : online) {
+            if (c >= CPU_SETSIZE) break;
+            if (have_mask && !CPU_ISSET(c, &allowed)) continue;
+            char path[256];
+            CpuInfo info{c, 0, c, 0};
+            snprintf(path, sizeof(path),
+                     "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", c);
+            info.socket = std::max(0, read_sys_int(path, 0));
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", c);
+            info.core = read_sys_int(path, c);
+            cpus.push_back(info);
+        }
+
+        if (cpus.empty()) {
+            cpus.push_back(CpuInfo{0, 0, 0, 0});
+        }
+
+        // Renumerar sockets de forma densa (0..k-1) y calcular hermanos SMT
+        std::vector<int> socket_ids;
+        for (const CpuInfo& info : cpus) socket_ids.push_back(info.socket);
+        std::sort(socket_ids.begin(), socket_ids.end());
+        socket_ids.erase(std::unique(socket_ids.begin(), socket_ids.end()), socket_ids.end());
+        for (CpuInfo& info : cpus) {
+            info.socket = (int)(std::lower_bound(socket_ids.begin(), socket_ids.end(),
+                                                 info.socket) - socket_ids.begin());
+        }
+        num_sockets = (int)socket_ids.size();
+
+        for (CpuInfo& info : cpus) {
+            for (const CpuInfo& other : cpus) {
+                if (other.socket == info.socket && other.core == info.core &&
+                    other.cpu < info.cpu) {
+                    info.sibling++;
+                }
+            }
+        }
+    }
+};
+
+// ============================================================================
+// POLÍTICAS DE COLOCACIÓN
+// ============================================================================
+
+enum class PlacementPolicy {
+    NONE,           // Sin afinidad: el scheduler decide (comportamiento original)
+    COMPACT,        // Hilo i -> i-ésima CPU llenando un socket a la vez
+    SCATTER,        // Hilo i -> sockets alternados, un hilo por núcleo físico
+    PER_SOCKET,     // Hilo confinado a todas las CPUs de un socket
+    EXPLICIT,       // Hilo i -> lista[i % n] dada por el usuario
+    CROSS_SOCKET    // Grupo 0 en un socket, grupo 1 en otro (productor/consumidor)
+};
+
+/**
+ * Política de colocación seleccionada con --placement
+ *
+ * Formatos aceptados:
+ *   none | compact | scatter | per-socket | per-socket:S |
+ *   list:0,2,4-7 | cross-socket
+ *
+ * index es la posición global del hilo (los grupos no se solapan: en p2 los
+ * consumidores van después de los productores); group distingue roles
+ * (0 = productores, 1 = consumidores) y solo lo usa cross-socket
+ */
+struct ThreadPlacement {
+    PlacementPolicy policy = PlacementPolicy::NONE;
+    std::vector<int> cpu_list;   // Para EXPLICIT
+    int socket = -1;             // Para PER_SOCKET fijo (-1 = round-robin)
+
+    bool parse(const char* spec) {
+        cpu_list.clear();
+        socket = -1;
+        if (strcmp(spec, "none") == 0) {
+            policy = PlacementPolicy::NONE;
+        } else if (strcmp(spec, "compact") == 0) {
+            policy = PlacementPolicy::COMPACT;
+        } else if (strcmp(spec, "scatter") == 0) {
+            policy = PlacementPolicy::SCATTER;
+        } else if (strcmp(spec, "per-socket") == 0) {
+            policy = PlacementPolicy::PER_SOCKET;
+        } else if (strncmp(spec, "per-socket:", 11) == 0) {
+            policy = PlacementPolicy::PER_SOCKET;
+            char* end;
+            socket = (int)strtol(spec + 11, &end, 10);
+            if (end == spec + 11 || *end != '\0' || socket < 0 ||
+                socket >= CpuTopology::get().num_sockets) {
+                return false;
+            }
+        } else if (strncmp(spec, "list:", 5) == 0) {
+            policy = PlacementPolicy::EXPLICIT;
+            if (!parse_cpu_list(spec + 5, &cpu_list)) return false;
+            for (int c : cpu_list) {
+                if (!CpuTopology::get().has_cpu(c)) {
+                    fprintf(stderr, "CPU %d no está disponible para este proceso\n", c);
+                    return false;
+                }
+            }
+        } else if (strcmp(spec, "cross-socket") == 0) {
+            policy = PlacementPolicy::CROSS_SOCKET;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    bool enabled() const { return policy != PlacementPolicy::NONE; }
+
+    /**
+     * Calcular la máscara de CPUs para un hilo
+     * @return: false si la política es NONE (no fijar)
+     */
+    bool cpuset_for(int index, int group, cpu_set_t* set) const {
+        const CpuTopology& topo = CpuTopology::get();
+        CPU_ZERO(set);
+
+        switch (policy) {
+        case PlacementPolicy::NONE:
+            return false;
+        case PlacementPolicy::COMPACT: {
+            std::vector<int> order = topo.compact_order();
+            CPU_SET(order[index % order.size()], set);
+            return true;
+        }
+        case PlacementPolicy::SCATTER: {
+            std::vector<int> order = topo.scatter_order();
+            CPU_SET(order[index % order.size()], set);
+            return true;
+        }
+        case PlacementPolicy::PER_SOCKET: {
+            int s = (socket >= 0) ? socket : index % topo.num_sockets;
+            for (int c : topo.socket_cpus(s)) CPU_SET(c, set);
+            return true;
+        }
+        case PlacementPolicy::EXPLICIT:
+            CPU_SET(cpu_list[index % cpu_list.size()], set);
+            return true;
+        case PlacementPolicy::CROSS_SOCKET: {
+            if (topo.num_sockets > 1) {
+                std::vector<int> cpus = topo.socket_cpus(group == 0 ? 0 : 1);
+                CPU_SET(cpus[index % cpus.size()], set);
+            } else {
+                // Un solo socket: usar extremos opuestos del orden compacto
+                std::vector<int> order = topo.compact_order();
+                std::size_t pos = index % order.size();
+                CPU_SET(group == 0 ? order[pos] : order[order.size() - 1 - pos], set);
+            }
+            return true;
+        }
+        }
+        return false;
+    }
+
+    std::string describe() const {
+        const CpuTopology& topo = CpuTopology::get();
+        std::string name;
+        switch (policy) {
+        case PlacementPolicy::NONE:         name = "none"; break;
+        case PlacementPolicy::COMPACT:      name = "compact"; break;
+        case PlacementPolicy::SCATTER:      name = "scatter"; break;
+        case PlacementPolicy::PER_SOCKET:
+            name = (socket >= 0) ? "per-socket:" + std::to_string(socket) : "per-socket";
+            break;
+        case PlacementPolicy::EXPLICIT:
+            name = "list:";
+            for (std::size_t i = 0; i < cpu_list.size(); i++) {
+                name += (i ? "," : "") + std::to_string(cpu_list[i]);
+            }
+            break;
+        case PlacementPolicy::CROSS_SOCKET: name = "cross-socket"; break;
+        }
+        return name + " (" + std::to_string(topo.cpus.size()) + " CPUs, " +
+               std::to_string(topo.num_sockets) + " socket(s))";
+    }
+};
+
+/**
+ * Extraer "--placement X" o "--placement=X" de argv
+ * Compacta argv para que los parámetros posicionales conserven su índice
+ *
+ * @return: false si la política es inválida (mensaje ya impreso)
+ */
+inline bool extract_placement_arg(int* argc, char** argv, ThreadPlacement* placement) {
+    int out = 1;
+    bool ok = true;
+    for (int i = 1; i < *argc; i++) {
+        const char* spec = nullptr;
+        if (strcmp(argv[i], "--placement") == 0 && i + 1 < *argc) {
+            spec = argv[++i];
+        } else if (strncmp(argv[i], "--placement=", 12) == 0) {
+            spec = argv[i] + 12;
+        } else {
+            argv[out++] = argv[i];
+            continue;
+        }
+        if (!placement->parse(spec)) {
+            fprintf(stderr, "Política de colocación inválida: '%s'\n"
+                            "Use: none | compact | scatter | per-socket[:S] | "
+                            "list:0,2-5 | cross-socket\n", spec);
+            ok = false;
+        }
+    }
+    *argc = out;
+    argv[out] = nullptr;
+    return ok;
+}
+
+// ============================================================================
+// CREACIÓN DE HILOS CON AFINIDAD
+// ============================================================================
+
+/**
+ * pthread_create con la afinidad de la política aplicada desde el inicio
+ * (pthread_attr_setaffinity_np: el hilo nunca corre fuera de su CPU)
+ *
+ * Si el kernel rechaza la máscara, se avisa (una vez) y se crea sin fijar
+ */
+inline int placement_thread_create(pthread_t* thread, const ThreadPlacement& placement,
+                                   int index, int group,
+                                   void* (*func)(void*), void* arg) {
+    cpu_set_t set;
+    if (!placement.cpuset_for(index, group, &set)) {
+        return pthread_create(thread, nullptr, func, arg);
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    int result = pthread_create(thread, &attr, func, arg);
+    pthread_attr_destroy(&attr);
+
+    if (result != 0) {
+        static bool warned = false;
+        if (!warned) {
+            fprintf(stderr, "Warning: no se pudo fijar afinidad del hilo %d (grupo %d): %s\n",
+                    index, group, strerror(result));
+            warned = true;
+        }
+        result = pthread_create(thread, nullptr, func, arg);
+    }
+    return result;
+}
+
+/**
+ * Primera CPU de la máscara asignada (para reportes); -1 si no se fija
+ */
+inline int placement_cpu_of(const ThreadPlacement& placement, int index, int group) {
+    cpu_set_t set;
+    if (!placement.cpuset_for(index, group, &set)) return -1;
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (CPU_ISSET(c, &set)) return c;
+    }
+    return -1;
+}
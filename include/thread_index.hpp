@@ -0,0 +1,92 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Índice Denso por Hilo
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Dar a cada hilo vivo un índice pequeño y exclusivo para usarlo
+ *           en arreglos de datos por hilo (cachés, slots de época)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+// Hilos vivos simultáneos como máximo (índices 0 .. MAX_THREAD_INDEX - 1)
+constexpr int MAX_THREAD_INDEX = 256;
+
+// ============================================================================
+// ASIGNACIÓN DE ÍNDICES
+// ============================================================================
+
+/**
+ * Reparto de índices: primero el último liberado (LIFO), si no hay, uno
+ * nuevo. Solo se usa al nacer y morir cada hilo, así que un mutex basta
+ */
+class ThreadIndexAllocator {
+private:
+    std::mutex mutex;
+    std::vector<int> released;
+    std::atomic<int> next{0};   // Se escribe con el mutex; limit() lo lee sin él
+
+public:
+    int acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!released.empty()) {
+            int index = released.back();
+            released.pop_back();
+            return index;
+        }
+        if (next.load() >= MAX_THREAD_INDEX) abort();  // Más hilos vivos que el máximo
+        return next++;
+    }
+
+    /**
+     * Cota de los índices repartidos hasta ahora (todos son < limit())
+     */
+    int limit() const { return next.load(); }
+
+    void release(int index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        released.push_back(index);
+    }
+
+    // Nunca se destruye: hilos que terminan después de los destructores
+    // estáticos (p. ej. los del pool al salir de main) aún liberan su índice
+    static ThreadIndexAllocator& instance() {
+        static ThreadIndexAllocator* allocator = new ThreadIndexAllocator();
+        return *allocator;
+    }
+};
+
+/**
+ * Índice del hilo actual, exclusivo mientras el hilo viva
+ *
+ * A diferencia de un contador round-robin, dos hilos vivos nunca comparten
+ * índice, así que el dato indexado puede ser no atómico si solo lo toca su
+ * dueño. Al terminar el hilo el índice se recicla: el siguiente hilo hereda
+ * el dato por hilo tal como quedó (quien lo use debe tolerarlo).
+ */
+inline int thread_index() {
+    struct Holder {
+        int index;
+        Holder() : index(ThreadIndexAllocator::instance().acquire()) {}
+        ~Holder() { ThreadIndexAllocator::instance().release(index); }
+    };
+    thread_local Holder holder;
+    return holder.index;
+}
+
+/**
+ * Índices en uso como máximo: quien recorre datos por hilo puede parar aquí
+ * en vez de en MAX_THREAD_INDEX. Un hilo que obtiene su índice después de
+ * la lectura queda fuera; seq_cst permite ordenarlo con un protocolo tipo
+ * Dekker (ver BigReaderRWLock)
+ */
+inline int thread_index_limit() {
+    return ThreadIndexAllocator::instance().limit();
+}
@@ -0,0 +1,314 @@
+/**
+ * Universidad del Valle de Guatemala
+ * CC3086 Programación de Microprocesadores
+ * Laboratorio 6 - Pool Persistente de Hilos con Barrera de Inicio
+ *
+ * Autor: Adrian Penagos
+ * Fecha: Septiembre 2025
+ * Propósito: Reutilizar hilos entre corridas para que pthread_create/join
+ *           quede fuera de la región medida
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <cassert>
+#include <vector>
+#include "thread_affinity.hpp"
+#include "timing.hpp"
+
+// ============================================================================
+// TAREAS DEL POOL
+// ============================================================================
+
+/**
+ * Trabajo para un worker: misma firma que pthread_create
+ * group es el rol del hilo para la política de colocación (0 = productores,
+ * 1 = consumidores, ...)
+ */
+struct PoolTask {
+    void* (*func)(void*);
+    void* arg;
+    int group;
+};
+
+// ============================================================================
+// LATCH (CUENTA REGRESIVA)
+// ============================================================================
+
+/**
+ * Esperar a que N hilos terminen una fase sin hacer join
+ * (p. ej. "todos los productores terminaron" mientras el pool sigue activo)
+ */
+class Latch {
+private:
+    pthread_mutex_t mutex;
+    pthread_cond_t zero;
+    int count;
+
+public:
+    explicit Latch(int initial) : count(initial) {
+        pthread_mutex_init(&mutex, nullptr);
+        pthread_cond_init(&zero, nullptr);
+    }
+
+    ~Latch() {
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy(&zero);
+    }
+
+    Latch(const Latch&) = delete;
+    Latch& operator=(const Latch&) = delete;
+
+    void count_down() {
+        pthread_mutex_lock(&mutex);
+        if (count > 0 && --count == 0) {
+            pthread_cond_broadcast(&zero);
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+
+    void wait() {
+        pthread_mutex_lock(&mutex);
+        while (count > 0) {
+            pthread_cond_wait(&zero, &mutex);
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+};
+
+// ============================================================================
+// CLASE THREADPOOL
+// ============================================================================
+
+/**
+ * Pool de hilos persistentes con barrera de inicio
+ *
+ * launch(tasks):
+ *   1. Crea workers si hacen falta (solo la primera vez / al crecer)
+ *   2. Espera a que TODOS estén estacionados en la condición de inicio
+ *   3. Aplica la afinidad de cada tarea y los libera con un broadcast
+ *   4. Los participantes se encuentran en una barrera por espera activa;
+ *      el último en llegar marca el instante de inicio
+ * wait():
+ *   Espera a que termine la última tarea y devuelve la duración entre
+ *   la barrera de inicio y el fin de la última tarea
+ *
+ * Así la medición no incluye crear hilos ni despertarlos del futex.
+ * Los workers i >= tasks.size() siguen estacionados durante la corrida.
+ */
+class ThreadPool {
+private:
+    struct Worker {
+        ThreadPool* pool;
+        int index;
+        pthread_t thread;
+        cpu_set_t mask;       // Afinidad aplicada actualmente
+        bool pinned;
+    };
+
+    std::vector<Worker*> workers;
+    const ThreadPlacement* placement = nullptr;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t start_cond;    // Workers esperan aquí una nueva generación
+    pthread_cond_t parked_cond;   // launch() espera a que todos estén estacionados
+    pthread_cond_t done_cond;     // wait() espera a que terminen las tareas
+
+    std::vector<PoolTask> tasks;
+    unsigned long generation = 0;
+    int parked = 0;
+    int active = 0;               // Tareas de la generación actual
+    int remaining = 0;            // Tareas sin terminar
+    bool stop = false;
+
+    // Barrera de inicio por espera activa (fuera del mutex)
+    std::atomic<int> arrived{0};
+    std::atomic<unsigned long> released{0};
+
+    double release_time = 0.0;
+    double finish_time = 0.0;
+
+    static void* worker_main(void* p) {
+        Worker* self = static_cast<Worker*>(p);
+        self->pool->worker_loop(self);
+        return nullptr;
+    }
+
+    void worker_loop(Worker* self) {
+        pthread_mutex_lock(&mutex);
+        // Un worker creado durante launch() no debe tomar tareas viejas
+        unsigned long seen = generation;
+        for (;;) {
+            parked++;
+            if (parked == (int)workers.size()) {
+                pthread_cond_signal(&parked_cond);
+            }
+            while (generation == seen && !stop) {
+                pthread_cond_wait(&start_cond, &mutex);
+            }
+            parked--;
+            if (stop) break;
+
+            seen = generation;
+            if (self->index >= active) continue;  // No participa en esta corrida
+
+            PoolTask task = tasks[self->index];
+            int participants = active;
+            pthread_mutex_unlock(&mutex);
+
+            // Barrera de inicio: el último en llegar marca t0 y libera al resto
+            if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == participants) {
+                release_time = now_s();
+                released.store(seen, std::memory_order_release);
+            } else {
+                for (int spins = 0; released.load(std::memory_order_acquire) != seen; spins++) {
+                    if (spins > 100) sched_yield();
+                }
+            }
+
+            task.func(task.arg);
+
+            pthread_mutex_lock(&mutex);
+            if (--remaining == 0) {
+                finish_time = now_s();
+                pthread_cond_signal(&done_cond);
+            }
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+
+    // Requiere el mutex tomado
+    void grow_to(int count) {
+        while ((int)workers.size() < count) {
+            Worker* w = new Worker{this, (int)workers.size(), pthread_t{}, cpu_set_t{}, false};
+            CPU_ZERO(&w->mask);
+            if (placement) {
+                w->pinned = placement->cpuset_for(w->index, 0, &w->mask);
+            }
+            workers.push_back(w);
+            int result = placement
+                ? placement_thread_create(&w->thread, *placement, w->index, 0, worker_main, w)
+                : pthread_create(&w->thread, nullptr, worker_main, w);
+            assert(result == 0);  // Verificar creación exitosa
+            (void)result;
+        }
+    }
+
+    // Requiere el mutex tomado; el worker está estacionado
+    void apply_placement(Worker* w, int group) {
+        if (!placement) return;
+        cpu_set_t mask;
+        if (!placement->cpuset_for(w->index, group, &mask)) return;
+        if (w->pinned && CPU_EQUAL(&mask, &w->mask)) return;
+        if (pthread_setaffinity_np(w->thread, sizeof(mask), &mask) == 0) {
+            w->mask = mask;
+            w->pinned = true;
+        }
+    }
+
+public:
+    ThreadPool() {
+        pthread_mutex_init(&mutex, nullptr);
+        pthread_cond_init(&start_cond, nullptr);
+        pthread_cond_init(&parked_cond, nullptr);
+        pthread_cond_init(&done_cond, nullptr);
+    }
+
+    ~ThreadPool() {
+        pthread_mutex_lock(&mutex);
+        stop = true;
+        pthread_cond_broadcast(&start_cond);
+        pthread_mutex_unlock(&mutex);
+
+        for (Worker* w : workers) {
+            pthread_join(w->thread, nullptr);
+            delete w;
+        }
+
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy(&start_cond);
+        pthread_cond_destroy(&parked_cond);
+        pthread_cond_destroy(&done_cond);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Política de colocación para los workers (antes de la primera corrida)
+     */
+    void set_placement(const ThreadPlacement* p) {
+        pthread_mutex_lock(&mutex);
+        placement = p;
+        pthread_mutex_unlock(&mutex);
+    }
+
+    /**
+     * Crear workers por adelantado (opcional: launch() crece solo)
+     */
+    void reserve(int count) {
+        pthread_mutex_lock(&mutex);
+        grow_to(count);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    /**
+     * Liberar las tareas: tasks[i] corre en el worker i
+     * Retorna cuando las tareas fueron liberadas (no espera a que terminen)
+     */
+    void launch(const std::vector<PoolTask>& new_tasks) {
+        pthread_mutex_lock(&mutex);
+        assert(remaining == 0);  // No hay otra corrida en curso
+
+        grow_to((int)new_tasks.size());
+        while (parked < (int)workers.size()) {
+            pthread_cond_wait(&parked_cond, &mutex);
+        }
+
+        tasks = new_tasks;
+        active = (int)tasks.size();
+        remaining = active;
+        arrived.store(0, std::memory_order_relaxed);
+        release_time = finish_time = now_s();
+
+        for (int i = 0; i < active; i++) {
+            apply_placement(workers[i], tasks[i].group);
+        }
+
+        generation++;
+        pthread_cond_broadcast(&start_cond);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    /**
+     * Esperar a que terminen todas las tareas liberadas por launch()
+     * @return: segundos entre la barrera de inicio y el fin de la última tarea
+     */
+    double wait() {
+        pthread_mutex_lock(&mutex);
+        while (remaining > 0) {
+            pthread_cond_wait(&done_cond, &mutex);
+        }
+        double elapsed = finish_time - release_time;
+        pthread_mutex_unlock(&mutex);
+        return elapsed;
+    }
+
+    /**
+     * launch() + wait()
+     */
+    double run(const std::vector<PoolTask>& new_tasks) {
+        launch(new_tasks);
+        return wait();
+    }
+
+    int size() {
+        pthread_mutex_lock(&mutex);
+        int count = (int)workers.size();
+        pthread_mutex_unlock(&mutex);
+        return count;
+    }
+};
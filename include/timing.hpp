@@ -11,6 +11,8 @@
 #pragma once
 
 #include <ctime>
+#include <cmath>
+#include <cstdint>
 #include <chrono>
 #include <string>
 #include <vector>
@@ -30,6 +32,16 @@ inline double now_s() {
     return ts.tv_sec + ts.tv_nsec * 1e-9;
 }
 
+/**
+ * Obtener timestamp actual en nanosegundos enteros (monotonic clock)
+ * Para marcar eventos individuales sin perder resolución en un double
+ */
+inline uint64_t now_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
 /**
  * Obtener timestamp actual en milisegundos
  */
@@ -96,6 +108,14 @@ public:
         return elapsed;
     }
     
+    /**
+     * Registrar una medición tomada externamente (p. ej. duración devuelta
+     * por el propio benchmark, sin el costo de preparación)
+     */
+    void add_measurement(double seconds) {
+        measurements.push_back(seconds);
+    }
+    
     /**
      * Medir una función automáticamente
      */
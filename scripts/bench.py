@@ -56,6 +56,7 @@ WARMUP_ITERATIONS = 1
 
 # Archivos de resultados
 RESULTS_FILE = DATA_DIR / "benchmark_results.csv"
+SCALING_FILE = DATA_DIR / "p1_scaling.csv"
 ANALYSIS_FILE = DATA_DIR / "analysis_report.json"
 REPORT_FILE = DATA_DIR / "performance_report.html"
 
@@ -228,7 +229,8 @@ class Lab06Benchmarker:
         elif practice == 'p2_ring':
             cmd_parts.extend([str(params['producers']), str(params['consumers']), str(params['items'])])
         elif practice == 'p3_rw':
-            cmd_parts.extend([str(params['threads']), str(params['operations'])])
+            # El escenario de crecimiento (10M claves) no cabe en el timeout
+            cmd_parts.extend(['--growth-keys=0', str(params['threads']), str(params['operations'])])
         elif practice == 'p4_deadlock':
             cmd_parts.extend([str(params['threads']), str(params.get('skip_demo', 1))])
         elif practice == 'p5_pipeline':
@@ -683,6 +685,37 @@ class Lab06Benchmarker:
 # FUNCIONES DE ANÁLISIS Y REPORTES
 # ============================================================================
 
+def run_p1_sweep(max_threads: int, iterations: int, repetitions: int,
+                 output: Path = SCALING_FILE, timeout: int = DEFAULT_TIMEOUT) -> List[Dict[str, str]]:
+    """Barrido de escalabilidad de p1: el binario emite CSV, no hay parseo de texto"""
+    executable = BIN_DIR / "p1_counter"
+    cmd = [str(executable), "--sweep", f"1..{max_threads}", str(iterations),
+           "--reps", str(repetitions)]
+    print(f"📈 Barrido de escalabilidad: {' '.join(cmd)}")
+    
+    proc = subprocess.run(cmd, capture_output=True, text=True,
+                          timeout=timeout * max_threads * 8)
+    if proc.returncode != 0:
+        print(f"❌ p1_counter --sweep falló: {proc.stderr.strip()}")
+        sys.exit(1)
+    
+    rows = list(csv.DictReader(proc.stdout.splitlines()))
+    output.parent.mkdir(exist_ok=True)
+    output.write_text(proc.stdout)
+    
+    # Punto de colapso: primera cantidad de hilos con eficiencia < 50%
+    print(f"{'Estrategia':<18} {'ops/seg @max':>16} {'eficiencia @max':>16} {'colapso':>8}")
+    for strategy in dict.fromkeys(r['strategy'] for r in rows):
+        series = [r for r in rows if r['strategy'] == strategy]
+        last = series[-1]
+        collapse = next((r['threads'] for r in series
+                         if float(r['scaling_efficiency']) < 0.5), '-')
+        print(f"{strategy:<18} {float(last['ops_per_sec']):>16.0f} "
+              f"{float(last['scaling_efficiency']):>16.2f} {collapse:>8}")
+    
+    print(f"✅ CSV guardado en: {output}")
+    return rows
+
 def analyze_csv_results(csv_file: Path):
     """Analizar resultados desde archivo CSV"""
     if not csv_file.exists():
@@ -916,6 +949,7 @@ Ejemplos de uso:
   python3 bench.py --analyze data/results.csv     # Analizar resultados
   python3 bench.py --report data/                  # Generar reporte HTML
   python3 bench.py --quick p3_rw                  # Test rápido práctica 3
+  python3 bench.py --sweep 8                       # Escalabilidad p1 con 1..8 hilos (CSV)
         """
     )
     
@@ -934,6 +968,10 @@ Ejemplos de uso:
     parser.add_argument('--output', type=Path, help='Archivo de salida para resultados')
     parser.add_argument('--plots', action='store_true', help='Generar solo gráficas')
     parser.add_argument('--verbose', '-v', action='store_true', help='Output detallado')
+    parser.add_argument('--sweep', type=int, metavar='N',
+                       help='Barrido de escalabilidad de p1_counter con 1..N hilos')
+    parser.add_argument('--iterations', type=int, default=100000,
+                       help='Iteraciones por hilo para --sweep')
     
     args = parser.parse_args()
     
@@ -954,6 +992,11 @@ Ejemplos de uso:
         generate_html_report(args.report)
         return
     
+    if args.sweep:
+        run_p1_sweep(args.sweep, args.iterations, repetitions,
+                     args.output or SCALING_FILE, timeout)
+        return
+    
     if args.plots and args.analyze:
         if HAS_MATPLOTLIB and HAS_PANDAS:
             df = pd.read_csv(args.analyze)
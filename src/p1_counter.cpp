@@ -11,23 +11,59 @@
 
 #include <pthread.h>
 #include <cstdio>
+#include <cstddef>
 #include <cstdlib>
 #include <vector>
 #include <atomic>
-#include <chrono>
 #include <cassert>
 #include <cmath> 
+#include <algorithm>
+#include <cstring>
+#include "sharded_counter.hpp"
+#include "thread_affinity.hpp"
+#include "thread_pool.hpp"
+#include "timing.hpp"
+
+// ============================================================================
+// CONSTANTES Y CONFIGURACIÓN
+// ============================================================================
+
+constexpr std::size_t COUNTER_SHARDS = 64;  // Slots de ShardedCounter (cubre 32-64 núcleos)
+constexpr long CLOCK_CHECK_INTERVAL = 256;   // Iteraciones entre lecturas del reloj (timed)
+
+// Colocación de hilos seleccionada con --placement (por defecto: sin afinidad)
+static ThreadPlacement g_placement;
+
+// Hilos persistentes: crear/join hilos queda fuera de la región medida
+static ThreadPool g_pool;
 
 // ============================================================================
 // ESTRUCTURAS Y TIPOS
 // ============================================================================
 
+/**
+ * Contador local alineado a línea de caché
+ * Cada instancia ocupa una línea completa, así dos hilos nunca
+ * escriben en la misma línea (evita false sharing)
+ */
+struct alignas(CACHE_LINE_SIZE) PaddedCounter {
+    long value = 0;
+};
+
+static_assert(sizeof(PaddedCounter) == CACHE_LINE_SIZE,
+              "PaddedCounter debe ocupar exactamente una línea de caché");
+
 struct Args {
     long iters;                    // Iteraciones por hilo
     long* global;                  // Puntero a contador global
     pthread_mutex_t* mtx;          // Mutex para protección
     long* local_counter;           // Para versión sharded
     std::atomic<long>* atomic_counter; // Para versión atomic
+    PaddedCounter* padded_counter; // Para versión sharded con padding
+    ShardedCounter<COUNTER_SHARDS>* sharded_counter; // Para versión ShardedCounter
+    long batch_size;               // Publicar cada K incrementos (batched)
+    double max_staleness_us;       // Cota de antigüedad del acumulado (timed)
+    long flushes;                  // Salida: publicaciones hechas al atomic
 };
 
 // ============================================================================
@@ -83,6 +119,38 @@ void* worker_sharded(void* p) {
     return nullptr;
 }
 
+/**
+ * Worker sharded con padding: Igual que sharded, pero cada contador local
+ * vive en su propia línea de caché (alignas(64))
+ * En la versión sharded simple, 8 longs adyacentes comparten una línea y
+ * cada incremento invalida la copia de los demás hilos (false sharing)
+ */
+void* worker_sharded_padded(void* p) {
+    auto* a = static_cast<Args*>(p);
+    long* counter = &a->padded_counter->value;  // Mismo patrón de acceso que sharded
+    
+    for (long i = 0; i < a->iters; i++) {
+        (*counter)++;  // Línea de caché exclusiva de este hilo
+    }
+    
+    return nullptr;
+}
+
+/**
+ * Worker con ShardedCounter: librería reutilizable (include/sharded_counter.hpp)
+ * add() escribe en un slot propio con fetch_add relaxed, sin fase reduce
+ * posterior: el total se puede leer mientras los hilos siguen escribiendo
+ */
+void* worker_sharded_counter(void* p) {
+    auto* a = static_cast<Args*>(p);
+    
+    for (long i = 0; i < a->iters; i++) {
+        a->sharded_counter->add(1);
+    }
+    
+    return nullptr;
+}
+
 /**
  * Worker atomic: Usa std::atomic para operaciones lock-free
  * Hardware garantiza atomicidad sin necesidad de locks explícitos
@@ -98,26 +166,115 @@ void* worker_atomic(void* p) {
     return nullptr;
 }
 
+/**
+ * Worker atomic batched: Acumula localmente y publica cada K incrementos
+ * La línea del atomic se transfiere entre núcleos una vez por lote en vez
+ * de una vez por incremento. Costo: el valor global atrasa hasta K-1 por hilo
+ */
+void* worker_atomic_batched(void* p) {
+    auto* a = static_cast<Args*>(p);
+    long pending = 0;
+    long flushes = 0;
+    
+    for (long i = 0; i < a->iters; i++) {
+        pending++;
+        if (pending == a->batch_size) {
+            a->atomic_counter->fetch_add(pending, std::memory_order_relaxed);
+            pending = 0;
+            flushes++;
+        }
+    }
+    
+    // Flush final: publicar lo que quedó en el acumulador
+    if (pending > 0) {
+        a->atomic_counter->fetch_add(pending, std::memory_order_relaxed);
+        flushes++;
+    }
+    
+    // Contador local: se publica una vez (Args vecinos comparten línea)
+    a->flushes = flushes;
+    return nullptr;
+}
+
+/**
+ * Worker atomic timed: Acumula localmente y publica cuando el acumulado
+ * supera max_staleness_us de antigüedad
+ * El reloj se consulta cada CLOCK_CHECK_INTERVAL iteraciones para que
+ * clock_gettime no domine el costo del incremento
+ */
+void* worker_atomic_timed(void* p) {
+    auto* a = static_cast<Args*>(p);
+    const double max_age_s = a->max_staleness_us * 1e-6;
+    double last_flush = now_s();
+    long pending = 0;
+    long flushes = 0;
+    
+    for (long i = 0; i < a->iters; i++) {
+        pending++;
+        if ((i % CLOCK_CHECK_INTERVAL) == 0) {
+            double now = now_s();
+            if (now - last_flush >= max_age_s) {
+                a->atomic_counter->fetch_add(pending, std::memory_order_relaxed);
+                pending = 0;
+                last_flush = now;
+                flushes++;
+            }
+        }
+    }
+    
+    if (pending > 0) {
+        a->atomic_counter->fetch_add(pending, std::memory_order_relaxed);
+        flushes++;
+    }
+    
+    a->flushes = flushes;
+    return nullptr;
+}
+
 // ============================================================================
 // FUNCIÓN DE BENCHMARK
 // ============================================================================
 
-double benchmark_strategy(const char* strategy_name, 
-                         void* (*worker_func)(void*), 
-                         int num_threads, 
-                         long iterations,
-                         long expected_result) {
-    
-    printf("\n--- Benchmarking %s ---\n", strategy_name);
-    printf("Threads: %d, Iterations per thread: %ld\n", num_threads, iterations);
+/**
+ * Parámetros extra de las estrategias con acumulación local
+ */
+struct BatchConfig {
+    long batch_size = 1;            // K: publicar cada K incrementos
+    double max_staleness_us = 0.0;  // Publicar si el acumulado tiene más de X µs
+};
+
+/**
+ * Resultado de una ejecución (sin imprimir nada)
+ */
+struct StrategyResult {
+    double duration = 0.0;          // Segundos desde la barrera de inicio hasta el fin
+    long final_result = 0;          // Valor final del contador
+    long flushes = 0;               // Publicaciones al atomic (estrategias batched)
+    long concurrent_reads = 0;      // Lecturas hechas con escritores activos
+    long stale_reads = 0;           // read_exact() que devolvió la última consistente
+    bool reads_consistent = true;   // Las lecturas concurrentes fueron válidas
+};
+
+/**
+ * Ejecutar una estrategia y devolver resultados crudos
+ * No imprime: la usan tanto el reporte legible como los barridos
+ */
+StrategyResult run_strategy(void* (*worker_func)(void*), 
+                            int num_threads, 
+                            long iterations,
+                            long expected_result,
+                            const BatchConfig& batch = BatchConfig{}) {
+    StrategyResult res;
     
     // Variables para diferentes estrategias
     long global_counter = 0;
     pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
     std::vector<long> local_counters(num_threads, 0);
+    std::vector<PaddedCounter> padded_counters(num_threads);
     std::atomic<long> atomic_counter{0};
+    ShardedCounter<COUNTER_SHARDS> sharded_counter;
     
-    std::vector<pthread_t> threads(num_threads);
+    std::vector<PoolTask> tasks(num_threads);
     std::vector<Args> args(num_threads);
     
     // Preparar argumentos para cada hilo
@@ -127,58 +284,254 @@ double benchmark_strategy(const char* strategy_name,
             .global = &global_counter,
             .mtx = &mtx,
             .local_counter = &local_counters[i],
-            .atomic_counter = &atomic_counter
+            .atomic_counter = &atomic_counter,
+            .padded_counter = &padded_counters[i],
+            .sharded_counter = &sharded_counter,
+            .batch_size = batch.batch_size,
+            .max_staleness_us = batch.max_staleness_us,
+            .flushes = 0
         };
+        tasks[i] = {worker_func, &args[i], 0};
     }
     
-    // Medir tiempo de ejecución
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    // Crear hilos
-    for (int i = 0; i < num_threads; i++) {
-        int result = pthread_create(&threads[i], nullptr, worker_func, &args[i]);
-        assert(result == 0);  // Verificar creación exitosa
-    }
-    
-    // Esperar terminación de todos los hilos
-    for (int i = 0; i < num_threads; i++) {
-        int result = pthread_join(threads[i], nullptr);
-        assert(result == 0);  // Verificar join exitoso
-    }
+    // Liberar workers del pool (la medición empieza en la barrera de inicio)
+    g_pool.launch(tasks);
     
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration<double>(end - start).count();
+    // Esperar que terminen todas las tareas
+    res.duration = g_pool.wait();
     
     // Calcular resultado final según la estrategia
-    long final_result;
     if (worker_func == worker_sharded) {
         // Para sharded, sumar todos los contadores locales (fase reduce)
-        final_result = 0;
+        res.final_result = 0;
         for (long local : local_counters) {
-            final_result += local;
+            res.final_result += local;
+        }
+    } else if (worker_func == worker_sharded_padded) {
+        res.final_result = 0;
+        for (const PaddedCounter& local : padded_counters) {
+            res.final_result += local.value;
         }
-    } else if (worker_func == worker_atomic) {
-        final_result = atomic_counter.load();
+    } else if (worker_func == worker_sharded_counter) {
+        res.final_result = sharded_counter.read_exact().value;
+    } else if (worker_func == worker_atomic || worker_func == worker_atomic_batched ||
+               worker_func == worker_atomic_timed) {
+        res.final_result = atomic_counter.load();
     } else {
-        final_result = global_counter;
+        res.final_result = global_counter;
+    }
+    
+    for (const Args& a : args) {
+        res.flushes += a.flushes;
+    }
+    
+    // ShardedCounter permite leer el total con los escritores activos: se
+    // comprueba en una segunda corrida sin medir, para que las lecturas del
+    // hilo principal no entren en el tiempo de esta estrategia
+    if (worker_func == worker_sharded_counter) {
+        sharded_counter.reset();
+        g_pool.launch(tasks);
+        long last_exact = 0;
+        for (int r = 0; r < 100; r++) {
+            long approx = sharded_counter.read_approx();
+            CounterSnapshot exact = sharded_counter.read_exact();
+            // Un contador monótono nunca retrocede ni supera el total esperado
+            if (approx > expected_result || exact.value > expected_result ||
+                exact.value < last_exact) {
+                res.reads_consistent = false;
+            }
+            last_exact = exact.value;
+            if (!exact.fresh) res.stale_reads++;
+            res.concurrent_reads += 2;
+        }
+        g_pool.wait();
+        if (sharded_counter.read_exact().value != expected_result) res.reads_consistent = false;
     }
     
+    // Limpiar recursos
+    pthread_mutex_destroy(&mtx);
+    
+    return res;
+}
+
+double benchmark_strategy(const char* strategy_name, 
+                         void* (*worker_func)(void*), 
+                         int num_threads, 
+                         long iterations,
+                         long expected_result,
+                         const BatchConfig& batch = BatchConfig{}) {
+    
+    printf("\n--- Benchmarking %s ---\n", strategy_name);
+    printf("Threads: %d, Iterations per thread: %ld\n", num_threads, iterations);
+    
+    StrategyResult res = run_strategy(worker_func, num_threads, iterations,
+                                      expected_result, batch);
+    
     // Reporte de resultados
-    printf("Resultado: %ld (esperado: %ld)\n", final_result, expected_result);
-    printf("Tiempo: %.6f segundos\n", duration);
-    printf("Throughput: %.2f ops/seg\n", (double)(num_threads * iterations) / duration);
+    printf("Resultado: %ld (esperado: %ld)\n", res.final_result, expected_result);
+    printf("Tiempo: %.6f segundos\n", res.duration);
+    printf("Throughput: %.2f ops/seg\n", (double)(num_threads * iterations) / res.duration);
+    if (res.concurrent_reads > 0) {
+        printf("Lecturas concurrentes (corrida aparte, sin medir): %ld (%s), "
+               "%ld exactas de una lectura anterior\n", res.concurrent_reads,
+               res.reads_consistent ? "monótonas y acotadas" : "❌ inconsistentes",
+               res.stale_reads);
+    }
+    if (res.flushes > 0) {
+        printf("Publicaciones al atomic: %ld (%.1f incrementos por publicación)\n",
+               res.flushes, (double)expected_result / res.flushes);
+    }
     
-    if (final_result != expected_result) {
+    if (res.final_result != expected_result) {
         printf("❌ INCONSISTENCIA DETECTADA - Diferencia: %ld\n", 
-               expected_result - final_result);
+               expected_result - res.final_result);
     } else {
         printf("✅ Resultado correcto\n");
     }
     
-    // Limpiar recursos
-    pthread_mutex_destroy(&mtx);
+    return res.duration;
+}
+
+/**
+ * Curva throughput vs staleness para la acumulación local
+ *
+ * Staleness por cantidad: a lo sumo (K-1) incrementos sin publicar por hilo.
+ * Staleness por tiempo: intervalo promedio entre publicaciones de un hilo
+ * (cuánto tarda un incremento, en promedio, en volverse visible)
+ */
+void report_staleness_curve(int num_threads, long iterations, long user_batch,
+                            double user_staleness_us) {
+    long expected_total = (long)num_threads * iterations;
+    
+    std::vector<long> batch_sizes = {1, 4, 16, 64, 256, 1024, 4096};
+    if (std::find(batch_sizes.begin(), batch_sizes.end(), user_batch) == batch_sizes.end()) {
+        batch_sizes.push_back(user_batch);
+        std::sort(batch_sizes.begin(), batch_sizes.end());
+    }
+    
+    printf("\n=== CURVA THROUGHPUT vs STALENESS (publicar cada K) ===\n");
+    printf("%8s %14s %16s %18s %6s\n", 
+           "K", "ops/seg", "max sin publicar", "intervalo (µs)", "ok");
+    for (long k : batch_sizes) {
+        BatchConfig cfg;
+        cfg.batch_size = k;
+        StrategyResult res = run_strategy(worker_atomic_batched, num_threads, iterations,
+                                          expected_total, cfg);
+        double flushes_per_thread = (double)res.flushes / num_threads;
+        printf("%8ld %14.0f %16ld %18.3f %6s\n", k,
+               expected_total / res.duration,
+               (long)num_threads * (k - 1),
+               res.duration * 1e6 / flushes_per_thread,
+               res.final_result == expected_total ? "✅" : "❌");
+    }
+    
+    std::vector<double> staleness_values = {1.0, 10.0, 100.0, 1000.0};
+    if (std::find(staleness_values.begin(), staleness_values.end(), user_staleness_us) ==
+        staleness_values.end()) {
+        staleness_values.push_back(user_staleness_us);
+        std::sort(staleness_values.begin(), staleness_values.end());
+    }
     
-    return duration;
+    printf("\n=== CURVA THROUGHPUT vs STALENESS (cota de tiempo) ===\n");
+    printf("%10s %14s %16s %18s %6s\n", 
+           "cota (µs)", "ops/seg", "publicaciones", "intervalo (µs)", "ok");
+    for (double staleness_us : staleness_values) {
+        BatchConfig cfg;
+        cfg.max_staleness_us = staleness_us;
+        StrategyResult res = run_strategy(worker_atomic_timed, num_threads, iterations,
+                                          expected_total, cfg);
+        double flushes_per_thread = (double)res.flushes / num_threads;
+        printf("%10.1f %14.0f %16ld %18.3f %6s\n", staleness_us,
+               expected_total / res.duration,
+               res.flushes,
+               res.duration * 1e6 / flushes_per_thread,
+               res.final_result == expected_total ? "✅" : "❌");
+    }
+}
+
+// ============================================================================
+// BARRIDO DE ESCALABILIDAD (CSV)
+// ============================================================================
+
+struct StrategySpec {
+    const char* name;
+    void* (*worker)(void*);
+    BatchConfig batch;
+};
+
+/**
+ * Ejecutar todas las estrategias para cada cantidad de hilos en
+ * [min_threads, max_threads] con varias repeticiones
+ *
+ * Emite CSV en stdout (una fila por estrategia y cantidad de hilos).
+ * scaling_efficiency = ops/seg(t) / (ops/seg(t0) * t / t0), donde t0 es la
+ * cantidad mínima del barrido (1 por defecto): 1.0 = escalamiento lineal
+ */
+void run_scaling_sweep(int min_threads, int max_threads, long iterations, int repetitions,
+                       long batch_size, double max_staleness_us) {
+    BatchConfig batched_cfg;
+    batched_cfg.batch_size = batch_size;
+    BatchConfig timed_cfg;
+    timed_cfg.max_staleness_us = max_staleness_us;
+    
+    const std::vector<StrategySpec> strategies = {
+        {"naive",           worker_naive,           BatchConfig{}},
+        {"mutex",           worker_mutex,           BatchConfig{}},
+        {"sharded",         worker_sharded,         BatchConfig{}},
+        {"sharded_padded",  worker_sharded_padded,  BatchConfig{}},
+        {"sharded_counter", worker_sharded_counter, BatchConfig{}},
+        {"atomic",          worker_atomic,          BatchConfig{}},
+        {"atomic_batched",  worker_atomic_batched,  batched_cfg},
+        {"atomic_timed",    worker_atomic_timed,    timed_cfg},
+    };
+    
+    printf("strategy,threads,iterations_per_thread,repetitions,mean_s,min_s,stddev_s,"
+           "ns_per_op,ops_per_sec,scaling_efficiency,correct\n");
+    
+    for (const StrategySpec& spec : strategies) {
+        double base_ops_per_sec = 0.0;
+        
+        for (int threads = min_threads; threads <= max_threads; threads++) {
+            long expected_total = (long)threads * iterations;
+            BenchmarkTimer timer(spec.name);
+            bool correct = true;
+            
+            // Calentamiento descartado (páginas, caché, frecuencia de CPU)
+            run_strategy(spec.worker, threads, iterations, expected_total, spec.batch);
+            
+            for (int rep = 0; rep < repetitions; rep++) {
+                StrategyResult res = run_strategy(spec.worker, threads, iterations,
+                                                  expected_total, spec.batch);
+                timer.add_measurement(res.duration);
+                if (res.final_result != expected_total) correct = false;
+            }
+            
+            double mean_s = timer.average();
+            double ops_per_sec = expected_total / mean_s;
+            if (threads == min_threads) base_ops_per_sec = ops_per_sec;
+            double efficiency = ops_per_sec / 
+                                (base_ops_per_sec * threads / (double)min_threads);
+            
+            printf("%s,%d,%ld,%d,%.9f,%.9f,%.9f,%.3f,%.0f,%.4f,%d\n",
+                   spec.name, threads, iterations, repetitions,
+                   mean_s, timer.minimum(), timer.standard_deviation(),
+                   mean_s * 1e9 / expected_total, ops_per_sec, efficiency,
+                   correct ? 1 : 0);
+            fflush(stdout);
+        }
+    }
+}
+
+/**
+ * Interpretar rango de hilos "A..B" o "N" (equivale a 1..N)
+ */
+bool parse_thread_range(const char* spec, int* min_threads, int* max_threads) {
+    if (sscanf(spec, "%d..%d", min_threads, max_threads) == 2) {
+        return *min_threads >= 1 && *max_threads >= *min_threads;
+    }
+    *min_threads = 1;
+    *max_threads = std::atoi(spec);
+    return *max_threads >= 1;
 }
 
 // ============================================================================
@@ -186,13 +539,60 @@ double benchmark_strategy(const char* strategy_name,
 // ============================================================================
 
 int main(int argc, char** argv) {
+    if (!extract_placement_arg(&argc, argv, &g_placement)) {
+        return 1;
+    }
+    g_pool.set_placement(&g_placement);
+    
+    // Opciones: --sweep A..B (barrido CSV) y --reps R (repeticiones por punto)
+    const char* sweep_spec = nullptr;
+    int repetitions = 5;
+    std::vector<char*> positional = {argv[0]};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) {
+            sweep_spec = argv[++i];
+        } else if (strncmp(argv[i], "--sweep=", 8) == 0) {
+            sweep_spec = argv[i] + 8;
+        } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            repetitions = std::atoi(argv[++i]);
+        } else if (strncmp(argv[i], "--reps=", 7) == 0) {
+            repetitions = std::atoi(argv[i] + 7);
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+    // En modo barrido los hilos vienen del rango: no hay posicional de hilos
+    if (sweep_spec) {
+        positional.insert(positional.begin() + 1, const_cast<char*>("0"));
+    }
+    int npos = (int)positional.size();
+    
     // Parámetros por defecto
-    int num_threads = (argc > 1) ? std::atoi(argv[1]) : 4;
-    long iterations = (argc > 2) ? std::atol(argv[2]) : 1000000;
+    int num_threads = (npos > 1) ? std::atoi(positional[1]) : 4;
+    long iterations = (npos > 2) ? std::atol(positional[2]) : 1000000;
+    long batch_size = (npos > 3) ? std::atol(positional[3]) : 64;
+    double max_staleness_us = (npos > 4) ? std::atof(positional[4]) : 100.0;
+    
+    if (batch_size < 1) batch_size = 1;
+    if (max_staleness_us < 0.0) max_staleness_us = 0.0;
+    if (repetitions < 1) repetitions = 1;
+    
+    if (sweep_spec) {
+        int min_threads, max_threads;
+        if (!parse_thread_range(sweep_spec, &min_threads, &max_threads)) {
+            fprintf(stderr, "Rango inválido para --sweep: '%s' (use A..B o N)\n", sweep_spec);
+            return 1;
+        }
+        run_scaling_sweep(min_threads, max_threads, iterations, repetitions,
+                          batch_size, max_staleness_us);
+        return 0;
+    }
     
     printf("=== LABORATORIO 6 - PRÁCTICA 1: RACE CONDITIONS ===\n");
     printf("Configuración: %d hilos, %ld iteraciones por hilo\n", 
            num_threads, iterations);
+    printf("Batched: K=%ld, cota de staleness=%.1f µs\n", batch_size, max_staleness_us);
+    printf("Afinidad: %s\n", g_placement.describe().c_str());
     
     long expected_total = (long)num_threads * iterations;
     
@@ -209,10 +609,34 @@ int main(int argc, char** argv) {
     double time_sharded = benchmark_strategy("Sharded", worker_sharded, 
                                            num_threads, iterations, expected_total);
     
-    printf("\n⚡ ESTRATEGIA 4: ATOMIC (Lock-free)\n");
+    printf("\n🧱 ESTRATEGIA 4: SHARDED PADDED (Contadores alineados a línea de caché)\n");
+    double time_padded = benchmark_strategy("Sharded Padded", worker_sharded_padded, 
+                                          num_threads, iterations, expected_total);
+    
+    printf("\n🧮 ESTRATEGIA 5: SHARDEDCOUNTER (Librería con lectura concurrente)\n");
+    double time_sharded_counter = benchmark_strategy("ShardedCounter", worker_sharded_counter, 
+                                                    num_threads, iterations, expected_total);
+    
+    printf("\n⚡ ESTRATEGIA 6: ATOMIC (Lock-free)\n");
     double time_atomic = benchmark_strategy("Atomic", worker_atomic, 
                                           num_threads, iterations, expected_total);
     
+    printf("\n📦 ESTRATEGIA 7: ATOMIC BATCHED (Publicar cada K incrementos)\n");
+    BatchConfig batched_cfg;
+    batched_cfg.batch_size = batch_size;
+    double time_batched = benchmark_strategy("Atomic Batched", worker_atomic_batched, 
+                                            num_threads, iterations, expected_total,
+                                            batched_cfg);
+    
+    printf("\n⏲️  ESTRATEGIA 8: ATOMIC TIMED (Publicar por antigüedad)\n");
+    BatchConfig timed_cfg;
+    timed_cfg.max_staleness_us = max_staleness_us;
+    double time_timed = benchmark_strategy("Atomic Timed", worker_atomic_timed, 
+                                          num_threads, iterations, expected_total,
+                                          timed_cfg);
+    
+    report_staleness_curve(num_threads, iterations, batch_size, max_staleness_us);
+    
     // Análisis comparativo
     printf("\n=== ANÁLISIS COMPARATIVO ===\n");
     printf("Tiempo Naive:   %.6f seg (baseline)\n", time_naive);
@@ -220,14 +644,34 @@ int main(int argc, char** argv) {
            time_mutex, time_mutex / time_naive);
     printf("Tiempo Sharded: %.6f seg (%.2fx vs naive)\n", 
            time_sharded, time_sharded / time_naive);
+    printf("Tiempo Padded:  %.6f seg (%.2fx vs naive)\n", 
+           time_padded, time_padded / time_naive);
+    printf("Tiempo SCntr:   %.6f seg (%.2fx vs naive)\n", 
+           time_sharded_counter, time_sharded_counter / time_naive);
     printf("Tiempo Atomic:  %.6f seg (%.2fx vs naive)\n", 
            time_atomic, time_atomic / time_naive);
+    printf("Tiempo Batched: %.6f seg (%.2fx vs naive)\n", 
+           time_batched, time_batched / time_naive);
+    printf("Tiempo Timed:   %.6f seg (%.2fx vs naive)\n", 
+           time_timed, time_timed / time_naive);
+    printf("Atomic / ShardedCounter: %.2fx (ganancia al evitar el atomic único)\n",
+           time_atomic / time_sharded_counter);
+    printf("Atomic / Batched (K=%ld): %.2fx (ganancia al publicar por lotes)\n",
+           batch_size, time_atomic / time_batched);
+    
+    // Costo del false sharing: sharded simple vs sharded con padding
+    printf("\n--- FALSE SHARING ---\n");
+    printf("Sharded / Padded: %.2fx (>1 = el false sharing cuesta throughput)\n",
+           time_sharded / time_padded);
     
     printf("\n=== OBSERVACIONES ===\n");
     printf("• Naive: Más rápido pero resultados incorrectos (race condition)\n");
     printf("• Mutex: Correcto pero con overhead de sincronización\n");
     printf("• Sharded: Reduce contención, pero requiere fase reduce\n");
+    printf("• Padded: Igual que sharded sin false sharing (un contador por línea)\n");
+    printf("• ShardedCounter: add() relaxed por slot, total legible en cualquier momento\n");
     printf("• Atomic: Lock-free, balance entre rendimiento y simplicidad\n");
+    printf("• Batched/Timed: Un fetch_add por lote; el total atrasa según K o la cota\n");
     
     return 0;
 }
\ No newline at end of file
@@ -10,28 +10,188 @@
  */
 
 #include <pthread.h>
+#include <sys/epoll.h>
 #include <cstdio>
 #include <cstddef>
 #include <cstdlib>
+#include <cstdint>
 #include <vector>
-#include <chrono>
 #include <cassert>
 #include <unistd.h>
+#include <sched.h>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+#include <new>
+#include "cacheline.hpp"
+#include "huge_pages.hpp"
+#include "latency_histogram.hpp"
+#include "ring.hpp"
+#include "thread_affinity.hpp"
+#include "thread_pool.hpp"
 
 // ============================================================================
 // CONSTANTES Y CONFIGURACIÓN
 // ============================================================================
 
-constexpr std::size_t QUEUE_SIZE = 1024;  // Tamaño del búfer circular
+constexpr std::size_t QUEUE_SIZE = 1024;  // Capacidad por defecto del búfer circular
 constexpr int POISON_PILL = -1;           // Señal de terminación
 
+/**
+ * Elemento que viaja por las colas: valor + instante en que se encoló
+ * (el consumidor mide la latencia de entrega contra now_ns())
+ */
+struct Item {
+    int value;
+    uint64_t enqueue_ns;
+};
+
+// Tamaño máximo de un registro (Item + carga útil)
+constexpr std::size_t MAX_RECORD_BYTES = 64 * 1024;
+
+/**
+ * Geometría de una cola, fijada al crearla (no al compilar)
+ *
+ * Cada slot guarda un registro de record_bytes: el Item al inicio y carga
+ * útil opaca después, para medir el costo de copiar registros reales.
+ * La capacidad se redondea a potencia de 2 para indexar con (i & mask)
+ */
+struct RingLayout {
+    std::size_t capacity = QUEUE_SIZE;
+    std::size_t mask = QUEUE_SIZE - 1;
+    std::size_t record_bytes = sizeof(Item);
+    bool huge_pages = false;  // Búfer en páginas de 2 MB (HugeBuffer)
+};
+
+RingLayout make_layout(std::size_t capacity, std::size_t record_bytes, bool huge_pages) {
+    RingLayout layout;
+    layout.capacity = round_up_pow2(capacity < 2 ? 2 : capacity);
+    layout.mask = layout.capacity - 1;
+    layout.record_bytes = round_up(record_bytes < sizeof(Item) ? sizeof(Item) : record_bytes,
+                                   alignof(Item));
+    layout.huge_pages = huge_pages;
+    return layout;
+}
+
+/**
+ * Registro index dentro de un arreglo de registros de stride bytes
+ */
+inline Item* record_at(void* base, std::size_t stride, std::size_t index) {
+    return reinterpret_cast<Item*>(static_cast<unsigned char*>(base) + index * stride);
+}
+
+inline const Item* record_at(const void* base, std::size_t stride, std::size_t index) {
+    return reinterpret_cast<const Item*>(static_cast<const unsigned char*>(base) + index * stride);
+}
+
+// Máximo de elementos por lote en ring_push_bulk/ring_pop_bulk desde los hilos
+constexpr int MAX_BATCH = 1024;
+
+// Colas sin locks: reintentos con pausa de CPU antes de ceder el núcleo
+constexpr int SPIN_LIMIT = 64;
+
+/**
+ * Implementación de la cola usada por run_benchmark
+ */
+enum class RingImpl {
+    MUTEX,  // MutexRing: mutex + variables de condición (cualquier P/C)
+    SPSC,   // Ring<Item>: sin locks ni copias, exactamente 1 productor y 1 consumidor
+    SPSC_EVENTFD,  // Ring<Item> con aviso por eventfd: el consumidor es un ciclo epoll
+    SPSC_CONDVAR,  // Ring<Item> con aviso por condvar: el mismo ciclo, bloquea en park()
+    MPMC    // MpmcRing: sin locks (Vyukov), cualquier P/C
+};
+
+const char* ring_impl_name(RingImpl impl) {
+    switch (impl) {
+        case RingImpl::SPSC: return "SPSC sin locks";
+        case RingImpl::SPSC_EVENTFD: return "SPSC + eventfd/epoll";
+        case RingImpl::SPSC_CONDVAR: return "SPSC + condvar";
+        case RingImpl::MPMC: return "MPMC sin locks";
+        default:             return "mutex + condvar";
+    }
+}
+
+// Colocación de hilos seleccionada con --placement (por defecto: sin afinidad)
+// Productores = grupo 0, consumidores = grupo 1 (cross-socket los separa)
+static ThreadPlacement g_placement;
+
+// Hilos persistentes: crear/join hilos queda fuera de la región medida
+static ThreadPool g_pool;
+
+// Geometría de las colas (--capacity, --record-bytes, --huge-pages)
+static RingLayout g_layout;
+
+// Modo barrido: sin mensajes por hilo ni reporte por corrida (solo CSV)
+static bool g_quiet = false;
+
+// ============================================================================
+// POLÍTICAS DE ESPERA
+// ============================================================================
+
+/**
+ * Espera entre reintentos: pausa de CPU unas cuantas veces y luego cede
+ * el núcleo, para no acaparar la CPU que necesita el otro lado si comparten
+ * núcleo
+ */
+inline void spin_backoff(int spins) {
+    if (spins < SPIN_LIMIT) {
+        cpu_relax();
+    } else {
+        sched_yield();
+    }
+}
+
+/**
+ * Espera adaptativa del anillo con mutex cuando está lleno/vacío:
+ * primero gira con pause, luego cede el núcleo y solo entonces duerme en la
+ * variable de condición. Si el otro lado llega en nanosegundos se evita la
+ * llamada al futex y el cambio de contexto. {0, 0} = dormir de inmediato
+ */
+struct WaitPolicy {
+    int spin_iters = 0;    // Reintentos con pause
+    int yield_iters = 0;   // Reintentos con sched_yield
+};
+
+/**
+ * Fase en la que terminó una espera
+ */
+enum class WaitPhase { SPIN, YIELD, PARK };
+
+/**
+ * Cuántas esperas resolvió cada fase (una por episodio de cola llena/vacía)
+ */
+struct WaitStats {
+    long spin = 0;
+    long yield = 0;
+    long park = 0;
+};
+
+/**
+ * Girar y luego ceder hasta que ready() sea verdadero, sin tomar locks
+ * @return: fase en la que se cumplió, o PARK si se agotó la política
+ */
+template<typename Ready>
+WaitPhase adaptive_wait(const WaitPolicy& policy, Ready ready) {
+    for (int i = 0; i < policy.spin_iters; i++) {
+        if (ready()) return WaitPhase::SPIN;
+        cpu_relax();
+    }
+    for (int i = 0; i < policy.yield_iters; i++) {
+        if (ready()) return WaitPhase::YIELD;
+        sched_yield();
+    }
+    return WaitPhase::PARK;
+}
+
 // ============================================================================
 // ESTRUCTURA DEL BÚFER CIRCULAR
 // ============================================================================
 
-struct Ring {
-    // Búfer circular para almacenar enteros
-    int buffer[QUEUE_SIZE];
+struct MutexRing {
+    // Búfer circular de registros (reservado aparte con ring_init)
+    RingLayout layout;
+    HugeBuffer storage;
+    unsigned char* buffer = nullptr;
     
     // Índices del búfer circular
     std::size_t head = 0;    // Índice donde se inserta (productor)
@@ -47,37 +207,129 @@ struct Ring {
     bool stop_requested = false;  // Bandera de shutdown solicitado
     bool force_stop = false;      // Terminación forzada (para pruebas de timeout)
     
+    // Espera adaptativa antes de pthread_cond_wait
+    WaitPolicy wait_policy;
+    
     // Estadísticas de monitoreo
     long total_produced = 0;
     long total_consumed = 0;
     long producer_blocks = 0;   // Cuántas veces el productor se bloqueo
     long consumer_blocks = 0;   // Cuántas veces el consumidor se bloqueo
+    WaitStats producer_waits;   // Fase que resolvió cada espera del productor
+    WaitStats consumer_waits;   // Fase que resolvió cada espera del consumidor
+    
+    // Copia de count que se puede leer sin el mutex mientras se gira.
+    // Se escribe dentro de la sección crítica; en su propia línea para que
+    // los hilos que giran no compitan con los datos protegidos
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> observed_count{0};
 };
 
+// ============================================================================
+// ESPERA DEL BÚFER CIRCULAR
+// ============================================================================
+
+/**
+ * Registrar en qué fase terminó una espera (mutex tomado)
+ */
+void record_wait(WaitStats* stats, WaitPhase phase) {
+    switch (phase) {
+        case WaitPhase::SPIN:  stats->spin++;  break;
+        case WaitPhase::YIELD: stats->yield++; break;
+        case WaitPhase::PARK:  stats->park++;  break;
+    }
+}
+
+/**
+ * Esperar espacio libre. Se llama y retorna con el mutex tomado
+ *
+ * Si la política lo permite, suelta el mutex para girar/ceder observando
+ * observed_count; al retomarlo vuelve a verificar count porque otro
+ * productor pudo ocupar el espacio. Si no alcanza, duerme como siempre.
+ * PATRÓN CRÍTICO: Usar while, no if
+ * Razón: Pueden ocurrir "spurious wakeups" - despertares sin causa real
+ * También maneja el caso donde múltiples hilos esperan y uno consume el espacio
+ */
+void ring_wait_not_full(MutexRing* ring) {
+    std::size_t capacity = ring->layout.capacity;
+    if (ring->count < capacity || ring->stop_requested || ring->force_stop) return;
+    
+    WaitPhase phase = WaitPhase::PARK;
+    const WaitPolicy& policy = ring->wait_policy;
+    if (policy.spin_iters > 0 || policy.yield_iters > 0) {
+        pthread_mutex_unlock(&ring->mutex);
+        phase = adaptive_wait(policy, [ring, capacity] {
+            return ring->observed_count.load(std::memory_order_relaxed) < capacity;
+        });
+        pthread_mutex_lock(&ring->mutex);
+        if (ring->count == capacity && !ring->stop_requested && !ring->force_stop) {
+            phase = WaitPhase::PARK;  // Otro productor ganó el espacio
+        }
+    }
+    record_wait(&ring->producer_waits, phase);
+    
+    while (ring->count == capacity && !ring->stop_requested && !ring->force_stop) {
+        ring->producer_blocks++;
+        // pthread_cond_wait libera el mutex ATÓMICAMENTE y duerme
+        // Al despertar, re-adquiere el mutex automáticamente
+        pthread_cond_wait(&ring->not_full, &ring->mutex);
+    }
+}
+
+/**
+ * Esperar datos disponibles. Se llama y retorna con el mutex tomado
+ */
+void ring_wait_not_empty(MutexRing* ring) {
+    if (ring->count > 0 || ring->stop_requested || ring->force_stop) return;
+    
+    WaitPhase phase = WaitPhase::PARK;
+    const WaitPolicy& policy = ring->wait_policy;
+    if (policy.spin_iters > 0 || policy.yield_iters > 0) {
+        pthread_mutex_unlock(&ring->mutex);
+        phase = adaptive_wait(policy, [ring] {
+            return ring->observed_count.load(std::memory_order_relaxed) > 0;
+        });
+        pthread_mutex_lock(&ring->mutex);
+        if (ring->count == 0 && !ring->stop_requested && !ring->force_stop) {
+            phase = WaitPhase::PARK;
+        }
+    }
+    record_wait(&ring->consumer_waits, phase);
+    
+    // Esperar mientras no hay datos Y no se ha solicitado parada
+    while (ring->count == 0 && !ring->stop_requested && !ring->force_stop) {
+        ring->consumer_blocks++;
+        pthread_cond_wait(&ring->not_empty, &ring->mutex);
+    }
+}
+
 // ============================================================================
 // OPERACIONES DEL BÚFER CIRCULAR
 // ============================================================================
 
+/**
+ * Reservar el búfer del anillo con la geometría indicada
+ * @return: false si no hubo memoria
+ */
+bool ring_init(MutexRing* ring, const RingLayout& layout) {
+    ring->layout = layout;
+    if (!ring->storage.allocate(layout.capacity * layout.record_bytes, layout.huge_pages)) {
+        return false;
+    }
+    ring->buffer = static_cast<unsigned char*>(ring->storage.data());
+    return true;
+}
+
 /**
  * Insertar elemento en la cola (operación de productor)
  * Bloquea si la cola está llena hasta que hay espacio disponible
  * 
  * @param ring: Puntero al búfer circular
- * @param value: Valor a insertar
+ * @param item: Registro a insertar (layout.record_bytes bytes)
  * @return: true si se insertó exitosamente, false si se solicitó parada
  */
-bool ring_push(Ring* ring, int value) {
+bool ring_push(MutexRing* ring, const Item* item) {
     pthread_mutex_lock(&ring->mutex);
-    
-    // PATRÓN CRÍTICO: Usar while, no if
-    // Razón: Pueden ocurrir "spurious wakeups" - despertares sin causa real
-    // También maneja el caso donde múltiples hilos esperan y uno consume el espacio
-    while (ring->count == QUEUE_SIZE && !ring->stop_requested && !ring->force_stop) {
-        ring->producer_blocks++;
-        // pthread_cond_wait libera el mutex ATÓMICAMENTE y duerme
-        // Al despertar, re-adquiere el mutex automáticamente
-        pthread_cond_wait(&ring->not_full, &ring->mutex);
-    }
+    ring_wait_not_full(ring);
     
     // Verificar si se solicitó terminación
     if (ring->stop_requested || ring->force_stop) {
@@ -86,9 +338,11 @@ bool ring_push(Ring* ring, int value) {
     }
     
     // SECCIÓN CRÍTICA: Insertar en el búfer circular
-    ring->buffer[ring->head] = value;
-    ring->head = (ring->head + 1) % QUEUE_SIZE;  // Aritmética modular para circular
+    const std::size_t stride = ring->layout.record_bytes;
+    std::memcpy(ring->buffer + ring->head * stride, item, stride);
+    ring->head = (ring->head + 1) & ring->layout.mask;  // Aritmética modular para circular
     ring->count++;
+    ring->observed_count.store(ring->count, std::memory_order_relaxed);
     ring->total_produced++;
     
     // Notificar a consumidores que hay datos disponibles
@@ -107,14 +361,9 @@ bool ring_push(Ring* ring, int value) {
  * @param output: Puntero donde almacenar el valor extraído
  * @return: true si se extrajo exitosamente, false si cola vacía y terminando
  */
-bool ring_pop(Ring* ring, int* output) {
+bool ring_pop(MutexRing* ring, Item* output) {
     pthread_mutex_lock(&ring->mutex);
-    
-    // Esperar mientras no hay datos Y no se ha solicitado parada
-    while (ring->count == 0 && !ring->stop_requested && !ring->force_stop) {
-        ring->consumer_blocks++;
-        pthread_cond_wait(&ring->not_empty, &ring->mutex);
-    }
+    ring_wait_not_empty(ring);
     
     // Si no hay datos y se solicitó parada, retornar false
     if (ring->count == 0 && (ring->stop_requested || ring->force_stop)) {
@@ -123,9 +372,11 @@ bool ring_pop(Ring* ring, int* output) {
     }
     
     // SECCIÓN CRÍTICA: Extraer del búfer circular
-    *output = ring->buffer[ring->tail];
-    ring->tail = (ring->tail + 1) % QUEUE_SIZE;
+    const std::size_t stride = ring->layout.record_bytes;
+    std::memcpy(output, ring->buffer + ring->tail * stride, stride);
+    ring->tail = (ring->tail + 1) & ring->layout.mask;
     ring->count--;
+    ring->observed_count.store(ring->count, std::memory_order_relaxed);
     ring->total_consumed++;
     
     // Notificar a productores que hay espacio disponible
@@ -135,11 +386,96 @@ bool ring_pop(Ring* ring, int* output) {
     return true;
 }
 
+/**
+ * Insertar un lote contiguo (operación de productor)
+ * Bloquea hasta que haya al menos un espacio libre y luego copia tantos
+ * elementos como quepan, con un solo lock y una sola notificación
+ *
+ * @param ring: Puntero al búfer circular
+ * @param src: n registros consecutivos (layout.record_bytes cada uno)
+ * @param n: Cantidad de elementos en src
+ * @return: elementos insertados (0 solo si se solicitó parada)
+ */
+std::size_t ring_push_bulk(MutexRing* ring, const Item* src, std::size_t n) {
+    if (n == 0) return 0;
+    pthread_mutex_lock(&ring->mutex);
+    ring_wait_not_full(ring);
+    
+    if (ring->stop_requested || ring->force_stop) {
+        pthread_mutex_unlock(&ring->mutex);
+        return 0;
+    }
+    
+    // A lo sumo dos segmentos: [head, fin del búfer) y [0, resto)
+    const std::size_t capacity = ring->layout.capacity;
+    const std::size_t stride = ring->layout.record_bytes;
+    std::size_t to_copy = std::min(n, capacity - ring->count);
+    std::size_t first = std::min(to_copy, capacity - ring->head);
+    std::memcpy(ring->buffer + ring->head * stride, src, first * stride);
+    std::memcpy(ring->buffer, record_at(src, stride, first), (to_copy - first) * stride);
+    
+    ring->head = (ring->head + to_copy) & ring->layout.mask;
+    ring->count += to_copy;
+    ring->observed_count.store(ring->count, std::memory_order_relaxed);
+    ring->total_produced += to_copy;
+    
+    // Una notificación por lote: con varios elementos pueden avanzar
+    // varios consumidores, así que se despierta a todos
+    if (to_copy == 1) {
+        pthread_cond_signal(&ring->not_empty);
+    } else {
+        pthread_cond_broadcast(&ring->not_empty);
+    }
+    
+    pthread_mutex_unlock(&ring->mutex);
+    return to_copy;
+}
+
+/**
+ * Extraer un lote contiguo (operación de consumidor)
+ * Bloquea hasta que haya al menos un elemento y luego copia hasta max
+ *
+ * @param ring: Puntero al búfer circular
+ * @param dst: Destino para hasta max registros consecutivos
+ * @param max: Capacidad de dst en registros
+ * @return: elementos extraídos (0 solo si cola vacía y terminando)
+ */
+std::size_t ring_pop_bulk(MutexRing* ring, Item* dst, std::size_t max) {
+    if (max == 0) return 0;
+    pthread_mutex_lock(&ring->mutex);
+    ring_wait_not_empty(ring);
+    
+    if (ring->count == 0 && (ring->stop_requested || ring->force_stop)) {
+        pthread_mutex_unlock(&ring->mutex);
+        return 0;
+    }
+    
+    std::size_t to_copy = std::min(max, ring->count);
+    const std::size_t stride = ring->layout.record_bytes;
+    std::size_t first = std::min(to_copy, ring->layout.capacity - ring->tail);
+    std::memcpy(dst, ring->buffer + ring->tail * stride, first * stride);
+    std::memcpy(record_at(dst, stride, first), ring->buffer, (to_copy - first) * stride);
+    
+    ring->tail = (ring->tail + to_copy) & ring->layout.mask;
+    ring->count -= to_copy;
+    ring->observed_count.store(ring->count, std::memory_order_relaxed);
+    ring->total_consumed += to_copy;
+    
+    if (to_copy == 1) {
+        pthread_cond_signal(&ring->not_full);
+    } else {
+        pthread_cond_broadcast(&ring->not_full);
+    }
+    
+    pthread_mutex_unlock(&ring->mutex);
+    return to_copy;
+}
+
 /**
  * Solicitar terminación graceful del búfer
  * Los productores y consumidores terminarán después de procesar elementos pendientes
  */
-void ring_shutdown(Ring* ring) {
+void ring_shutdown(MutexRing* ring) {
     pthread_mutex_lock(&ring->mutex);
     ring->stop_requested = true;
     
@@ -154,7 +490,7 @@ void ring_shutdown(Ring* ring) {
 /**
  * Forzar terminación inmediata (para pruebas de timeout)
  */
-void ring_force_stop(Ring* ring) {
+void ring_force_stop(MutexRing* ring) {
     pthread_mutex_lock(&ring->mutex);
     ring->force_stop = true;
     pthread_cond_broadcast(&ring->not_full);
@@ -165,7 +501,7 @@ void ring_force_stop(Ring* ring) {
 /**
  * Obtener estadísticas del búfer
  */
-void ring_get_stats(Ring* ring, long* produced, long* consumed, 
+void ring_get_stats(MutexRing* ring, long* produced, long* consumed, 
                    long* prod_blocks, long* cons_blocks, std::size_t* current_size) {
     pthread_mutex_lock(&ring->mutex);
     *produced = ring->total_produced;
@@ -176,84 +512,467 @@ void ring_get_stats(Ring* ring, long* produced, long* consumed,
     pthread_mutex_unlock(&ring->mutex);
 }
 
+/**
+ * Obtener en qué fase terminaron las esperas de productores y consumidores
+ */
+void ring_get_wait_stats(MutexRing* ring, WaitStats* producer_waits, WaitStats* consumer_waits) {
+    pthread_mutex_lock(&ring->mutex);
+    *producer_waits = ring->producer_waits;
+    *consumer_waits = ring->consumer_waits;
+    pthread_mutex_unlock(&ring->mutex);
+}
+
+// ============================================================================
+// COLA ACOTADA MPMC SIN LOCKS (VYUKOV)
+// ============================================================================
+
+/**
+ * Cola acotada de múltiples productores y consumidores (D. Vyukov)
+ *
+ * Cada celda lleva un número de secuencia que indica de quién es el turno:
+ * - sequence == pos       → libre para el productor que reclame pos
+ * - sequence == pos + 1   → contiene el dato de pos, lista para consumir
+ * - tras consumir, sequence = pos + capacity (libre para la siguiente vuelta)
+ *
+ * Un productor reclama su posición con CAS sobre enqueue_pos, escribe el dato
+ * y lo publica con un store release de sequence; el consumidor simétrico usa
+ * dequeue_pos. Productores y consumidores no comparten ningún contador y
+ * solo se comunican a través de la celda.
+ *
+ * Con registros de tamaño variable cada celda es [sequence][registro] con
+ * un paso de cell_stride bytes.
+ */
+struct MpmcRing {
+    // Solo lectura tras mpmc_init
+    alignas(CACHE_LINE_SIZE) RingLayout layout;
+    std::size_t cell_stride = 0;
+    unsigned char* cells = nullptr;
+    HugeBuffer storage;
+
+    // Contadores de posición: cada uno en su línea (productores vs consumidores)
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> enqueue_pos{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> dequeue_pos{0};
+
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> stop_requested{false};
+
+    // Solo en el camino lento (cola llena / vacía)
+    alignas(CACHE_LINE_SIZE) std::atomic<long> producer_blocks{0};
+    std::atomic<long> consumer_blocks{0};
+};
+
+// Offset del registro dentro de la celda (tras el número de secuencia)
+constexpr std::size_t MPMC_RECORD_OFFSET = round_up(sizeof(std::atomic<std::size_t>), alignof(Item));
+
+inline std::atomic<std::size_t>* mpmc_sequence(MpmcRing* ring, std::size_t pos) {
+    return reinterpret_cast<std::atomic<std::size_t>*>(
+        ring->cells + (pos & ring->layout.mask) * ring->cell_stride);
+}
+
+inline unsigned char* mpmc_record(MpmcRing* ring, std::size_t pos) {
+    return ring->cells + (pos & ring->layout.mask) * ring->cell_stride + MPMC_RECORD_OFFSET;
+}
+
+bool mpmc_init(MpmcRing* ring, const RingLayout& layout) {
+    ring->layout = layout;
+    ring->cell_stride = MPMC_RECORD_OFFSET + layout.record_bytes;
+    if (!ring->storage.allocate(layout.capacity * ring->cell_stride, layout.huge_pages)) {
+        return false;
+    }
+    ring->cells = static_cast<unsigned char*>(ring->storage.data());
+    for (std::size_t i = 0; i < layout.capacity; i++) {
+        new (mpmc_sequence(ring, i)) std::atomic<std::size_t>(i);
+    }
+    return true;
+}
+
+/**
+ * Intento de inserción sin bloqueo (lock-free)
+ * @return: false si la cola está llena
+ */
+bool mpmc_try_push(MpmcRing* ring, const Item* item) {
+    std::size_t pos = ring->enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        std::atomic<std::size_t>* sequence = mpmc_sequence(ring, pos);
+        std::size_t seq = sequence->load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        
+        if (diff == 0) {
+            // Celda libre: reclamarla (si falla, pos se actualiza al valor actual)
+            if (ring->enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                std::memcpy(mpmc_record(ring, pos), item, ring->layout.record_bytes);
+                sequence->store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // La celda aún tiene el dato de la vuelta anterior: llena
+        } else {
+            pos = ring->enqueue_pos.load(std::memory_order_relaxed);  // Otro productor avanzó
+        }
+    }
+}
+
+/**
+ * Intento de extracción sin bloqueo (lock-free)
+ * @return: false si la cola está vacía
+ */
+bool mpmc_try_pop(MpmcRing* ring, Item* output) {
+    std::size_t pos = ring->dequeue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        std::atomic<std::size_t>* sequence = mpmc_sequence(ring, pos);
+        std::size_t seq = sequence->load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        
+        if (diff == 0) {
+            if (ring->dequeue_pos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                std::memcpy(output, mpmc_record(ring, pos), ring->layout.record_bytes);
+                sequence->store(pos + ring->layout.capacity, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Nadie ha publicado en esta celda: vacía
+        } else {
+            pos = ring->dequeue_pos.load(std::memory_order_relaxed);  // Otro consumidor avanzó
+        }
+    }
+}
+
+/**
+ * Inserción con espera activa (misma semántica que ring_push)
+ * @return: true si se insertó, false si se solicitó parada
+ */
+bool mpmc_push(MpmcRing* ring, const Item* item) {
+    if (mpmc_try_push(ring, item)) return true;
+
+    ring->producer_blocks.fetch_add(1, std::memory_order_relaxed);
+    for (int spins = 0; !ring->stop_requested.load(std::memory_order_acquire); spins++) {
+        if (mpmc_try_push(ring, item)) return true;
+        spin_backoff(spins);
+    }
+    return false;
+}
+
+/**
+ * Extracción con espera activa (misma semántica que ring_pop)
+ * El shutdown llega después de que todos los productores terminaron, así que
+ * si la bandera ya estaba puesta y la cola se ve vacía, no queda nada en vuelo
+ * @return: true si se extrajo, false si cola vacía y terminando
+ */
+bool mpmc_pop(MpmcRing* ring, Item* output) {
+    if (mpmc_try_pop(ring, output)) return true;
+
+    ring->consumer_blocks.fetch_add(1, std::memory_order_relaxed);
+    for (int spins = 0; ; spins++) {
+        bool stopping = ring->stop_requested.load(std::memory_order_acquire);
+        if (mpmc_try_pop(ring, output)) return true;
+        if (stopping) return false;
+        spin_backoff(spins);
+    }
+}
+
+void mpmc_shutdown(MpmcRing* ring) {
+    ring->stop_requested.store(true, std::memory_order_release);
+}
+
+/**
+ * Estadísticas de la cola MPMC (solo después de que terminen todos los hilos)
+ * Cada posición reclamada corresponde a exactamente un elemento
+ */
+void mpmc_get_stats(MpmcRing* ring, long* produced, long* consumed,
+                    long* prod_blocks, long* cons_blocks, std::size_t* current_size) {
+    std::size_t enq = ring->enqueue_pos.load(std::memory_order_acquire);
+    std::size_t deq = ring->dequeue_pos.load(std::memory_order_acquire);
+    *produced = (long)enq;
+    *consumed = (long)deq;
+    *prod_blocks = ring->producer_blocks.load(std::memory_order_relaxed);
+    *cons_blocks = ring->consumer_blocks.load(std::memory_order_relaxed);
+    *current_size = enq - deq;
+}
+
 // ============================================================================
 // HILOS PRODUCTOR Y CONSUMIDOR
 // ============================================================================
 
 struct ProducerArgs {
-    Ring* ring;
+    RingImpl impl;
+    MutexRing* ring;
+    Ring<Item>* spsc;
+    MpmcRing* mpmc;
     int items_to_produce;
     int producer_id;
     int delay_us;  // Microsegundos de delay entre producciones
+    int batch_size;  // Elementos por operación (1 = ring_push)
+    std::size_t record_bytes;  // Tamaño de cada registro (Item + carga útil)
+    Latch* producers_done;  // Cuenta regresiva de productores activos
 };
 
 struct ConsumerArgs {
-    Ring* ring;
+    RingImpl impl;
+    MutexRing* ring;
+    Ring<Item>* spsc;
+    MpmcRing* mpmc;
     int consumer_id;
     int delay_us;  // Microsegundos de delay entre consumos
+    int batch_size;  // Máximo de elementos por operación (1 = ring_pop)
+    std::size_t record_bytes;  // Tamaño de cada registro (Item + carga útil)
+    long long checksum;  // Suma de valores consumidos (detecta pérdidas y duplicados)
+    LatencyHistogram* latency;  // Latencias de entrega de este consumidor (ns)
 };
 
+/**
+ * Insertar en la implementación de cola seleccionada
+ */
+bool producer_push(ProducerArgs* args, const Item* item) {
+    switch (args->impl) {
+        case RingImpl::SPSC:
+        case RingImpl::SPSC_EVENTFD:
+        case RingImpl::SPSC_CONDVAR: {
+            // El registro se construye dentro del slot: cabecera con emplace
+            // y carga útil escrita en el mismo slot antes de publicarlo
+            Item* slot = args->spsc->claim(*item);
+            if (!slot) return false;
+            std::memset(reinterpret_cast<unsigned char*>(slot) + sizeof(Item),
+                        args->producer_id & 0xff, args->record_bytes - sizeof(Item));
+            args->spsc->commit();
+            return true;
+        }
+        case RingImpl::MPMC: return mpmc_push(args->mpmc, item);
+        default:             return ring_push(args->ring, item);
+    }
+}
+
+/**
+ * Insertar un lote completo (n registros consecutivos) en la cola seleccionada
+ * El anillo con mutex usa ring_push_bulk (un lock por lote); las colas sin
+ * locks insertan elemento por elemento
+ * @return: elementos insertados (< n solo si se solicitó parada)
+ */
+int producer_push_batch(ProducerArgs* args, const Item* batch, int n) {
+    if (args->impl == RingImpl::MUTEX && n > 1) {
+        int pushed = 0;
+        while (pushed < n) {
+            std::size_t step = ring_push_bulk(args->ring,
+                                              record_at(batch, args->record_bytes, pushed),
+                                              n - pushed);
+            if (step == 0) break;
+            pushed += (int)step;
+        }
+        return pushed;
+    }
+    
+    for (int j = 0; j < n; j++) {
+        if (!producer_push(args, record_at(batch, args->record_bytes, j))) return j;
+    }
+    return n;
+}
+
+/**
+ * Extraer de la implementación de cola seleccionada
+ */
+bool consumer_pop(ConsumerArgs* args, Item* item) {
+    switch (args->impl) {
+        case RingImpl::SPSC:
+        case RingImpl::SPSC_EVENTFD:
+        case RingImpl::SPSC_CONDVAR: return args->spsc->pop(*item);
+        case RingImpl::MPMC: return mpmc_pop(args->mpmc, item);
+        default:             return ring_pop(args->ring, item);
+    }
+}
+
+/**
+ * Extraer hasta max elementos de la cola seleccionada
+ * @return: elementos extraídos (0 si cola vacía y terminando)
+ */
+int consumer_pop_batch(ConsumerArgs* args, Item* batch, int max) {
+    if (args->impl == RingImpl::MUTEX && max > 1) {
+        return (int)ring_pop_bulk(args->ring, batch, max);
+    }
+    return consumer_pop(args, batch) ? 1 : 0;
+}
+
 /**
  * Hilo productor: genera elementos y los inserta en la cola
  */
 void* producer_thread(void* arg) {
     ProducerArgs* args = static_cast<ProducerArgs*>(arg);
     
-    printf("[Productor %d] Iniciado - Producirá %d elementos\n", 
-           args->producer_id, args->items_to_produce);
+    if (!g_quiet) {
+        printf("[Productor %d] Iniciado - Producirá %d elementos\n", 
+               args->producer_id, args->items_to_produce);
+    }
+    
+    int batch_size = std::max(1, std::min(args->batch_size, MAX_BATCH));
+    const std::size_t stride = args->record_bytes;
+    
+    // Registros del lote en memoria contigua; la carga útil se rellena una vez
+    std::vector<uint64_t> storage((batch_size * stride + 7) / 8);
+    Item* batch = reinterpret_cast<Item*>(storage.data());
+    for (int j = 0; j < batch_size; j++) {
+        std::memset((unsigned char*)record_at(batch, stride, j) + sizeof(Item),
+                    args->producer_id & 0xff, stride - sizeof(Item));
+    }
     
-    for (int i = 0; i < args->items_to_produce; i++) {
-        int value = args->producer_id * 1000000 + i;  // Valor único identificable
+    for (int i = 0; i < args->items_to_produce; ) {
+        int n = std::min(batch_size, args->items_to_produce - i);
+        for (int j = 0; j < n; j++) {
+            record_at(batch, stride, j)->value = args->producer_id * 1000000 + i + j;  // Valor único identificable
+            
+            // Simular trabajo de producción
+            if (args->delay_us > 0) {
+                usleep(args->delay_us);
+            }
+        }
+        
+        // Marca de encolado justo antes de entregar el lote
+        uint64_t enqueue_ns = now_ns();
+        for (int j = 0; j < n; j++) {
+            record_at(batch, stride, j)->enqueue_ns = enqueue_ns;
+        }
         
-        if (!ring_push(args->ring, value)) {
+        int pushed = producer_push_batch(args, batch, n);
+        i += pushed;
+        if (pushed < n) {
             printf("[Productor %d] Terminado por shutdown en elemento %d\n", 
                    args->producer_id, i);
             break;
         }
-        
-        // Simular trabajo de producción
-        if (args->delay_us > 0) {
-            usleep(args->delay_us);
-        }
     }
     
-    printf("[Productor %d] Completado\n", args->producer_id);
+    if (!g_quiet) printf("[Productor %d] Completado\n", args->producer_id);
+    args->producers_done->count_down();
     return nullptr;
 }
 
+/**
+ * Procesar un registro recibido
+ * @return: true si era la poison pill (el consumidor debe terminar)
+ */
+bool consume_record(ConsumerArgs* args, const Item* record, uint64_t dequeue_ns,
+                    int* items_consumed) {
+    int value = record->value;
+    args->latency->record(dequeue_ns - record->enqueue_ns);
+    (*items_consumed)++;
+    args->checksum += value;
+    
+    // Procesar el elemento (aquí solo verificamos que no sea poison pill)
+    if (value == POISON_PILL) {
+        printf("[Consumidor %d] Recibió poison pill\n", args->consumer_id);
+        return true;
+    }
+    
+    // Simular trabajo de procesamiento
+    if (args->delay_us > 0) {
+        usleep(args->delay_us);
+    }
+    
+    // Log periódico para monitoreo
+    if (!g_quiet && *items_consumed % 10000 == 0) {
+        printf("[Consumidor %d] Procesados %d elementos\n", 
+               args->consumer_id, *items_consumed);
+    }
+    return false;
+}
+
+/**
+ * Consumidor como ciclo de eventos sobre Ring<Item> con aviso coalescido
+ *
+ * Con eventfd, el fd del anillo se registra en un epoll (en un servidor real
+ * el mismo epoll tendría sockets y timerfds). Cada vuelta drena todo lo
+ * publicado leyendo en el slot y solo entonces se declara dormido y bloquea
+ * en epoll_wait; el productor escribe al eventfd únicamente si ve esa
+ * declaración, así que con carga alta casi no hay syscalls. Con condvar
+ * (SPSC_CONDVAR) el ciclo es idéntico pero bloquea en park(): mismo anillo
+ * y mismo protocolo, solo cambia el mecanismo del aviso
+ * @return: true si recibió la poison pill
+ */
+bool consume_event_loop(ConsumerArgs* args, int* items_consumed) {
+    Ring<Item>* ring = args->spsc;
+    bool use_epoll = args->impl == RingImpl::SPSC_EVENTFD;
+    int epoll_fd = use_epoll ? epoll_create1(EPOLL_CLOEXEC) : -1;
+    epoll_event interest{};
+    interest.events = EPOLLIN;
+    interest.data.fd = ring->notify_fd();
+    if (use_epoll &&
+        (epoll_fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ring->notify_fd(), &interest) != 0)) {
+        printf("⚠️  [Consumidor %d] epoll no disponible, se usa front() bloqueante\n",
+               args->consumer_id);
+        if (epoll_fd >= 0) close(epoll_fd);
+        const Item* record;
+        while ((record = ring->front()) != nullptr) {
+            bool poisoned = consume_record(args, record, now_ns(), items_consumed);
+            ring->release();
+            if (poisoned) return true;
+        }
+        return false;
+    }
+    
+    bool poisoned = false;
+    for (;;) {
+        // Leer el cierre ANTES de drenar: si ya estaba cerrado, lo que se
+        // drena ahora es todo lo que el productor llegó a publicar
+        bool closing = ring->closed();
+        const Item* record;
+        while (!poisoned && (record = ring->try_front()) != nullptr) {
+            poisoned = consume_record(args, record, now_ns(), items_consumed);
+            ring->release();
+        }
+        if (poisoned || closing) break;
+        
+        if (ring->prepare_sleep()) {
+            if (use_epoll) {
+                epoll_event events[4];
+                epoll_wait(epoll_fd, events, 4, -1);
+            } else {
+                ring->park();
+            }
+            ring->finish_sleep();
+        }
+    }
+    if (epoll_fd >= 0) close(epoll_fd);
+    return poisoned;
+}
+
 /**
  * Hilo consumidor: extrae elementos de la cola y los procesa
  */
 void* consumer_thread(void* arg) {
     ConsumerArgs* args = static_cast<ConsumerArgs*>(arg);
     int items_consumed = 0;
-    int value;
+    int batch_size = std::max(1, std::min(args->batch_size, MAX_BATCH));
+    const std::size_t stride = args->record_bytes;
+    std::vector<uint64_t> storage((batch_size * stride + 7) / 8);
+    Item* batch = reinterpret_cast<Item*>(storage.data());
+    bool poisoned = false;
+    int n;
     
-    printf("[Consumidor %d] Iniciado\n", args->consumer_id);
+    if (!g_quiet) printf("[Consumidor %d] Iniciado\n", args->consumer_id);
     
-    while (ring_pop(args->ring, &value)) {
-        items_consumed++;
-        
-        // Procesar el elemento (aquí solo verificamos que no sea poison pill)
-        if (value == POISON_PILL) {
-            printf("[Consumidor %d] Recibió poison pill\n", args->consumer_id);
-            break;
+    if (args->impl == RingImpl::SPSC) {
+        // Sin copia de salida: el registro se lee dentro del slot y luego
+        // se devuelve el slot al productor
+        const Item* record;
+        while (!poisoned && (record = args->spsc->front()) != nullptr) {
+            poisoned = consume_record(args, record, now_ns(), &items_consumed);
+            args->spsc->release();
         }
-        
-        // Simular trabajo de procesamiento
-        if (args->delay_us > 0) {
-            usleep(args->delay_us);
-        }
-        
-        // Log periódico para monitoreo
-        if (items_consumed % 10000 == 0) {
-            printf("[Consumidor %d] Procesados %d elementos\n", 
-                   args->consumer_id, items_consumed);
+    } else if (args->impl == RingImpl::SPSC_EVENTFD || args->impl == RingImpl::SPSC_CONDVAR) {
+        poisoned = consume_event_loop(args, &items_consumed);
+    } else {
+        while (!poisoned && (n = consumer_pop_batch(args, batch, batch_size)) > 0) {
+            // Todo el lote salió de la cola en el mismo instante
+            uint64_t dequeue_ns = now_ns();
+            for (int j = 0; j < n && !poisoned; j++) {
+                poisoned = consume_record(args, record_at(batch, stride, j), dequeue_ns,
+                                          &items_consumed);
+            }
         }
     }
     
-    printf("[Consumidor %d] Terminado - Consumió %d elementos\n", 
-           args->consumer_id, items_consumed);
+    if (!g_quiet) {
+        printf("[Consumidor %d] Terminado - Consumió %d elementos\n", 
+               args->consumer_id, items_consumed);
+    }
     return nullptr;
 }
 
@@ -261,99 +980,572 @@ void* consumer_thread(void* arg) {
 // FUNCIÓN PRINCIPAL Y BENCHMARKS
 // ============================================================================
 
-void run_benchmark(int num_producers, int num_consumers, 
-                  int items_per_producer, int test_duration_sec) {
+/**
+ * Resultado de una corrida: throughput y latencia de entrega por elemento
+ */
+struct BenchResult {
+    double throughput = 0.0;  // Elementos consumidos / tiempo total
+    uint64_t p50_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    uint64_t max_ns = 0;
+    bool correct = false;     // Sin pérdidas ni duplicados
+    HugeBuffer::Backing backing = HugeBuffer::Backing::NONE;
+    long consumer_sleeps = 0; // Veces que el consumidor bloqueó (condvar o eventfd)
+    long notify_writes = -1;  // Avisos de Ring<T> (-1 si la cola no usa aviso coalescido)
+};
+
+/**
+ * Ejecutar una corrida P/C sobre la implementación de cola indicada
+ * producer_delay_us > 0 espacia las inserciones (carga baja: el consumidor
+ * duerme entre elementos y se mide el costo de despertarlo)
+ */
+BenchResult run_benchmark(int num_producers, int num_consumers, 
+                    int items_per_producer, int test_duration_sec,
+                    RingImpl impl = RingImpl::MUTEX, int batch_size = 1,
+                    WaitPolicy wait_policy = WaitPolicy{},
+                    const RingLayout& layout = g_layout,
+                    int producer_delay_us = 0) {
+    
+    if (!g_quiet) {
+        printf("\n=== BENCHMARK: %dP/%dC, %d elementos/productor (%s, lote %d) ===\n", 
+               num_producers, num_consumers, items_per_producer, ring_impl_name(impl), batch_size);
+        if (impl == RingImpl::MUTEX && (wait_policy.spin_iters > 0 || wait_policy.yield_iters > 0)) {
+            printf("Espera: %d spins, %d yields, luego condvar\n",
+                   wait_policy.spin_iters, wait_policy.yield_iters);
+        }
+    }
+    bool single = impl == RingImpl::SPSC || impl == RingImpl::SPSC_EVENTFD ||
+                  impl == RingImpl::SPSC_CONDVAR;
+    if (single && (num_producers != 1 || num_consumers != 1)) {
+        printf("⚠️  El anillo SPSC solo admite 1 productor y 1 consumidor\n");
+        return BenchResult{};
+    }
+    if (g_placement.enabled() && !g_quiet) {
+        printf("Afinidad: productor 0 -> CPU %d, consumidor 0 -> CPU %d\n",
+               placement_cpu_of(g_placement, 0, 0),
+               placement_cpu_of(g_placement, num_producers, 1));
+    }
     
-    printf("\n=== BENCHMARK: %dP/%dC, %d elementos/productor ===\n", 
-           num_producers, num_consumers, items_per_producer);
+    // Solo se reserva el búfer de la implementación usada
+    MutexRing ring;
+    ring.wait_policy = wait_policy;
+    Ring<Item>* spsc = new Ring<Item>();
+    MpmcRing* mpmc = new MpmcRing();
+    bool allocated = false;
+    const HugeBuffer* storage = nullptr;
+    switch (impl) {
+        case RingImpl::SPSC:
+        case RingImpl::SPSC_EVENTFD:
+        case RingImpl::SPSC_CONDVAR:
+            allocated = spsc->init(layout.capacity, layout.huge_pages, layout.record_bytes);
+            if (allocated && impl == RingImpl::SPSC_EVENTFD && !spsc->enable_eventfd()) {
+                printf("⚠️  No se pudo crear el eventfd\n");
+                delete spsc;
+                delete mpmc;
+                return BenchResult{};
+            }
+            storage = &spsc->memory();
+            break;
+        case RingImpl::MPMC: allocated = mpmc_init(mpmc, layout); storage = &mpmc->storage; break;
+        default:             allocated = ring_init(&ring, layout); storage = &ring.storage; break;
+    }
+    if (!allocated) {
+        printf("⚠️  Sin memoria para %zu registros de %zu bytes\n",
+               layout.capacity, layout.record_bytes);
+        delete spsc;
+        delete mpmc;
+        return BenchResult{};
+    }
+    if (!g_quiet) {
+        printf("Capacidad: %zu registros de %zu bytes, búfer en %s\n",
+               layout.capacity, layout.record_bytes, storage->describe());
+    }
     
-    Ring ring;
-    std::vector<pthread_t> producer_threads(num_producers);
-    std::vector<pthread_t> consumer_threads(num_consumers);
+    Latch producers_done(num_producers);
     std::vector<ProducerArgs> prod_args(num_producers);
     std::vector<ConsumerArgs> cons_args(num_consumers);
+    std::vector<LatencyHistogram> latencies(num_consumers);  // Uno por consumidor
+    std::vector<PoolTask> tasks;
     
-    auto start_time = std::chrono::high_resolution_clock::now();
-    
-    // Crear hilos productores
+    // Tareas productoras (grupo 0): workers 0..P-1
     for (int i = 0; i < num_producers; i++) {
-        prod_args[i] = {&ring, items_per_producer, i, 0};  // Sin delay inicial
-        pthread_create(&producer_threads[i], nullptr, producer_thread, &prod_args[i]);
+        prod_args[i] = {impl, &ring, spsc, mpmc, items_per_producer, i, producer_delay_us,
+                        batch_size, layout.record_bytes, &producers_done};
+        tasks.push_back({producer_thread, &prod_args[i], 0});
     }
     
-    // Crear hilos consumidores
+    // Tareas consumidoras (grupo 1): workers P..P+C-1
     for (int i = 0; i < num_consumers; i++) {
-        cons_args[i] = {&ring, i, 0};  // Sin delay inicial
-        pthread_create(&consumer_threads[i], nullptr, consumer_thread, &cons_args[i]);
+        cons_args[i] = {impl, &ring, spsc, mpmc, i, 0, batch_size,
+                        layout.record_bytes, 0, &latencies[i]};  // Sin delay inicial
+        tasks.push_back({consumer_thread, &cons_args[i], 1});
     }
     
-    // Esperar que terminen los productores
-    for (int i = 0; i < num_producers; i++) {
-        pthread_join(producer_threads[i], nullptr);
-    }
+    // Liberar todas las tareas juntas desde la barrera de inicio del pool
+    g_pool.launch(tasks);
     
-    printf("Todos los productores terminaron\n");
-    
-    // Esperar un poco para que los consumidores procesen elementos pendientes
-    sleep(1);
+    // Esperar que terminen los productores
+    producers_done.wait();
     
-    // Solicitar shutdown graceful
-    ring_shutdown(&ring);
+    if (!g_quiet) printf("Todos los productores terminaron\n");
     
-    // Esperar que terminen los consumidores
-    for (int i = 0; i < num_consumers; i++) {
-        pthread_join(consumer_threads[i], nullptr);
+    // Solicitar shutdown graceful: ya no entra nada más y las colas no
+    // descartan elementos al cerrarse, así que cada consumidor drena lo
+    // pendiente y sale solo cuando la cola queda vacía
+    switch (impl) {
+        case RingImpl::SPSC:
+        case RingImpl::SPSC_EVENTFD:
+        case RingImpl::SPSC_CONDVAR: spsc->close(); break;
+        case RingImpl::MPMC: mpmc_shutdown(mpmc); break;
+        default:             ring_shutdown(&ring); break;
     }
     
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration<double>(end_time - start_time).count();
+    // Esperar que terminen los consumidores: el fin del último es el instante
+    // en que se drenó la cola (no una espera fija)
+    double duration = g_pool.wait();
     
     // Obtener estadísticas finales
     long produced, consumed, prod_blocks, cons_blocks;
+    long consumer_sleeps = 0, notify_writes = -1;
+    long producer_sleeps = -1, space_notifies = 0;
     std::size_t final_size;
-    ring_get_stats(&ring, &produced, &consumed, &prod_blocks, &cons_blocks, &final_size);
+    switch (impl) {
+        case RingImpl::SPSC:
+        case RingImpl::SPSC_EVENTFD:
+        case RingImpl::SPSC_CONDVAR: {
+            RingStats stats = spsc->stats();
+            if (impl != RingImpl::SPSC) {
+                consumer_sleeps = stats.consumer_sleeps;
+                notify_writes = stats.notify_writes;
+            }
+            producer_sleeps = stats.producer_sleeps;
+            space_notifies = stats.space_notifies;
+            produced = stats.produced;
+            consumed = stats.consumed;
+            prod_blocks = stats.producer_waits;
+            cons_blocks = stats.consumer_waits;
+            final_size = stats.size;
+            break;
+        }
+        case RingImpl::MPMC:
+            mpmc_get_stats(mpmc, &produced, &consumed, &prod_blocks, &cons_blocks, &final_size);
+            break;
+        default:
+            ring_get_stats(&ring, &produced, &consumed, &prod_blocks, &cons_blocks, &final_size);
+            consumer_sleeps = cons_blocks;  // Cada bloqueo es un pthread_cond_wait
+            break;
+    }
+    
+    // Suma esperada: cada productor p genera p*1000000 + i, i = 0..N-1
+    long long expected_sum = 0;
+    for (int p = 0; p < num_producers; p++) {
+        expected_sum += (long long)p * 1000000 * items_per_producer +
+                        (long long)items_per_producer * (items_per_producer - 1) / 2;
+    }
+    long long consumed_sum = 0;
+    for (const ConsumerArgs& c : cons_args) {
+        consumed_sum += c.checksum;
+    }
+    
+    // Combinar los histogramas por hilo ahora que todos terminaron
+    LatencyHistogram latency;
+    for (const LatencyHistogram& h : latencies) {
+        latency.merge(h);
+    }
+    
+    BenchResult result;
+    result.throughput = consumed / duration;
+    result.p50_ns = latency.percentile(50.0);
+    result.p99_ns = latency.percentile(99.0);
+    result.p999_ns = latency.percentile(99.9);
+    result.max_ns = latency.max();
+    result.correct = (produced == consumed && consumed_sum == expected_sum);
+    result.backing = storage->backing();
+    result.consumer_sleeps = consumer_sleeps;
+    result.notify_writes = notify_writes;
     
     // Reporte de resultados
-    printf("\n--- RESULTADOS ---\n");
-    printf("Tiempo total: %.3f segundos\n", duration);
-    printf("Elementos producidos: %ld\n", produced);
-    printf("Elementos consumidos: %ld\n", consumed);
-    printf("Elementos perdidos: %ld\n", produced - consumed);
-    printf("Elementos finales en cola: %zu\n", final_size);
-    printf("Bloqueos de productor: %ld\n", prod_blocks);
-    printf("Bloqueos de consumidor: %ld\n", cons_blocks);
-    printf("Throughput producción: %.2f items/seg\n", produced / duration);
-    printf("Throughput consumo: %.2f items/seg\n", consumed / duration);
+    if (!g_quiet) {
+        printf("\n--- RESULTADOS ---\n");
+        printf("Tiempo total: %.3f segundos\n", duration);
+        printf("Elementos producidos: %ld\n", produced);
+        printf("Elementos consumidos: %ld\n", consumed);
+        printf("Elementos perdidos: %ld\n", produced - consumed);
+        printf("Elementos finales en cola: %zu\n", final_size);
+        printf("Checksum: %s\n", (consumed_sum == expected_sum) ? "✅ correcto" : "❌ pérdida o duplicado");
+        printf("Bloqueos de productor: %ld\n", prod_blocks);
+        printf("Bloqueos de consumidor: %ld\n", cons_blocks);
+        if (impl == RingImpl::SPSC_EVENTFD) {
+            printf("Consumidor dormido en epoll: %ld veces, avisos por eventfd: %ld\n",
+                   consumer_sleeps, notify_writes);
+        } else if (impl == RingImpl::SPSC_CONDVAR) {
+            printf("Consumidor dormido en park(): %ld veces, avisos por condvar: %ld\n",
+                   consumer_sleeps, notify_writes);
+        }
+        if (producer_sleeps >= 0) {
+            printf("Productor dormido con la cola llena: %ld veces, avisos de espacio: %ld\n",
+                   producer_sleeps, space_notifies);
+        }
+        if (impl == RingImpl::MUTEX) {
+            WaitStats prod_waits, cons_waits;
+            ring_get_wait_stats(&ring, &prod_waits, &cons_waits);
+            printf("Esperas de productor (spin/yield/park): %ld / %ld / %ld\n",
+                   prod_waits.spin, prod_waits.yield, prod_waits.park);
+            printf("Esperas de consumidor (spin/yield/park): %ld / %ld / %ld\n",
+                   cons_waits.spin, cons_waits.yield, cons_waits.park);
+        }
+        printf("Throughput producción: %.2f items/seg\n", produced / duration);
+        printf("Throughput consumo: %.2f items/seg\n", consumed / duration);
+        latency.print_summary("Latencia de entrega");
+    }
     
     // Limpiar recursos
     pthread_mutex_destroy(&ring.mutex);
     pthread_cond_destroy(&ring.not_full);
     pthread_cond_destroy(&ring.not_empty);
+    delete spsc;
+    delete mpmc;
+    
+    return result;
+}
+
+/**
+ * CPU en otro núcleo físico del mismo socket que cpu (para comparar contra
+ * cross-socket sin que productor y consumidor compartan núcleo SMT)
+ */
+int same_socket_peer(int cpu) {
+    const CpuTopology& topo = CpuTopology::get();
+    const CpuInfo* self = nullptr;
+    for (const CpuInfo& info : topo.cpus) {
+        if (info.cpu == cpu) self = &info;
+    }
+    if (!self) return cpu;
+    
+    for (const CpuInfo& info : topo.cpus) {
+        if (info.socket == self->socket && info.core != self->core) return info.cpu;
+    }
+    for (const CpuInfo& info : topo.cpus) {
+        if (info.cpu != cpu) return info.cpu;
+    }
+    return cpu;  // Máquina de una sola CPU
+}
+
+/**
+ * Barrido de capacidad × tamaño de registro (1P/1C, CSV en stdout)
+ *
+ * Para cada implementación mide throughput y latencia con colas de 64 a
+ * 16384 registros y registros de 16 B a 4 KB. MB/s = items/seg * registro:
+ * muestra cuándo el costo pasa de la sincronización a copiar bytes
+ */
+void run_capacity_sweep(int items_per_producer, int test_duration, bool huge_pages) {
+    const std::size_t capacities[] = {64, 256, 1024, 4096, 16384};
+    const std::size_t record_sizes[] = {16, 64, 256, 1024, 4096};
+    const RingImpl impls[] = {RingImpl::MUTEX, RingImpl::SPSC, RingImpl::MPMC};
+    
+    printf("impl,producers,consumers,capacity,record_bytes,huge_pages,backing,items,"
+           "items_per_sec,mb_per_sec,p50_ns,p99_ns,p999_ns,correct\n");
+    
+    for (RingImpl impl : impls) {
+        for (std::size_t capacity : capacities) {
+            for (std::size_t record_bytes : record_sizes) {
+                RingLayout layout = make_layout(capacity, record_bytes, huge_pages);
+                
+                // Calentamiento descartado
+                run_benchmark(1, 1, items_per_producer, test_duration, impl, 1,
+                              WaitPolicy{}, layout);
+                BenchResult r = run_benchmark(1, 1, items_per_producer, test_duration, impl, 1,
+                                              WaitPolicy{}, layout);
+                
+                const char* backing = "heap";
+                if (r.backing == HugeBuffer::Backing::HUGETLB) backing = "hugetlb";
+                if (r.backing == HugeBuffer::Backing::THP) backing = "thp";
+                
+                printf("%s,1,1,%zu,%zu,%d,%s,%d,%.0f,%.2f,%llu,%llu,%llu,%d\n",
+                       impl == RingImpl::MUTEX ? "mutex" : impl == RingImpl::SPSC ? "spsc" : "mpmc",
+                       layout.capacity, layout.record_bytes, huge_pages ? 1 : 0, backing,
+                       items_per_producer, r.throughput,
+                       r.throughput * layout.record_bytes / 1e6,
+                       (unsigned long long)r.p50_ns, (unsigned long long)r.p99_ns,
+                       (unsigned long long)r.p999_ns, r.correct ? 1 : 0);
+                fflush(stdout);
+            }
+        }
+    }
+}
+
+/**
+ * Extraer --wait S,Y (o --wait=S,Y) de argv: S spins con pause y Y yields
+ * antes de dormir en la variable de condición
+ * @return: false si el valor es inválido
+ */
+bool extract_wait_arg(int* argc, char** argv, WaitPolicy* policy) {
+    int out = 1;
+    bool ok = true;
+    for (int i = 1; i < *argc; i++) {
+        const char* spec = nullptr;
+        if (strcmp(argv[i], "--wait") == 0 && i + 1 < *argc) {
+            spec = argv[++i];
+        } else if (strncmp(argv[i], "--wait=", 7) == 0) {
+            spec = argv[i] + 7;
+        } else {
+            argv[out++] = argv[i];
+            continue;
+        }
+        if (sscanf(spec, "%d,%d", &policy->spin_iters, &policy->yield_iters) != 2 ||
+            policy->spin_iters < 0 || policy->yield_iters < 0) {
+            fprintf(stderr, "Política de espera inválida: '%s' (use --wait SPINS,YIELDS)\n", spec);
+            ok = false;
+        }
+    }
+    *argc = out;
+    argv[out] = nullptr;
+    return ok;
 }
 
 int main(int argc, char** argv) {
-    printf("=== LABORATORIO 6 - PRÁCTICA 2: PRODUCTOR-CONSUMIDOR ===\n");
+    if (!extract_placement_arg(&argc, argv, &g_placement)) {
+        return 1;
+    }
+    g_pool.set_placement(&g_placement);
+    
+    WaitPolicy user_wait{1000, 10};
+    if (!extract_wait_arg(&argc, argv, &user_wait)) {
+        return 1;
+    }
+    
+    // Opciones: --capacity N, --record-bytes B, --huge-pages, --sweep
+    long capacity = (long)QUEUE_SIZE;
+    long record_bytes = (long)sizeof(Item);
+    bool huge_pages = false;
+    bool sweep = false;
+    std::vector<char*> positional = {argv[0]};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc) {
+            capacity = std::atol(argv[++i]);
+        } else if (strncmp(argv[i], "--capacity=", 11) == 0) {
+            capacity = std::atol(argv[i] + 11);
+        } else if (strcmp(argv[i], "--record-bytes") == 0 && i + 1 < argc) {
+            record_bytes = std::atol(argv[++i]);
+        } else if (strncmp(argv[i], "--record-bytes=", 15) == 0) {
+            record_bytes = std::atol(argv[i] + 15);
+        } else if (strcmp(argv[i], "--huge-pages") == 0) {
+            huge_pages = true;
+        } else if (strcmp(argv[i], "--sweep") == 0) {
+            sweep = true;
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+    int npos = (int)positional.size();
+    
+    if (capacity < 1 || record_bytes < 1 || record_bytes > (long)MAX_RECORD_BYTES) {
+        fprintf(stderr, "Error: capacidad >= 1 y registro entre 1 y %zu bytes\n",
+                MAX_RECORD_BYTES);
+        return 1;
+    }
+    g_layout = make_layout((std::size_t)capacity, (std::size_t)record_bytes, huge_pages);
     
     // Parámetros configurables
-    int num_producers = (argc > 1) ? std::atoi(argv[1]) : 2;
-    int num_consumers = (argc > 2) ? std::atoi(argv[2]) : 2;
-    int items_per_producer = (argc > 3) ? std::atoi(argv[3]) : 100000;
-    int test_duration = (argc > 4) ? std::atoi(argv[4]) : 10;
+    int num_producers = (npos > 1) ? std::atoi(positional[1]) : 2;
+    int num_consumers = (npos > 2) ? std::atoi(positional[2]) : 2;
+    int items_per_producer = (npos > 3) ? std::atoi(positional[3]) : 100000;
+    int test_duration = (npos > 4) ? std::atoi(positional[4]) : 10;
+    int batch_size = (npos > 5) ? std::atoi(positional[5]) : 64;
+    if (batch_size < 1 || batch_size > MAX_BATCH) {
+        fprintf(stderr, "Error: el lote debe estar entre 1 y %d\n", MAX_BATCH);
+        return 1;
+    }
     
+    if (sweep) {
+        g_quiet = true;
+        run_capacity_sweep(items_per_producer, test_duration, huge_pages);
+        return 0;
+    }
+    
+    printf("=== LABORATORIO 6 - PRÁCTICA 2: PRODUCTOR-CONSUMIDOR ===\n");
     printf("Configuración por defecto: %dP/%dC\n", num_producers, num_consumers);
-    printf("Tamaño de cola: %zu elementos\n", QUEUE_SIZE);
+    printf("Capacidad de cola: %zu registros de %zu bytes%s\n", g_layout.capacity,
+           g_layout.record_bytes, huge_pages ? " (páginas grandes)" : "");
+    printf("Lote para push/pop masivo: %d elementos\n", batch_size);
+    printf("Espera adaptativa: %d spins, %d yields\n", user_wait.spin_iters, user_wait.yield_iters);
+    printf("Afinidad: %s\n", g_placement.describe().c_str());
     
-    // Ejecutar diferentes configuraciones de benchmark
-    run_benchmark(1, 1, items_per_producer, test_duration);  // SPSC (Single Producer Single Consumer)
-    run_benchmark(2, 1, items_per_producer, test_duration);  // MPSC (Multi Producer Single Consumer)
-    run_benchmark(1, 2, items_per_producer, test_duration);  // SPMC (Single Producer Multi Consumer)
-    run_benchmark(num_producers, num_consumers, items_per_producer, test_duration);  // MPMC
+    // Matriz de configuraciones: cada una con la cola con mutex y la MPMC sin
+    // locks; 1P/1C también con el anillo SPSC
+    struct QueueConfig {
+        const char* label;
+        int producers;
+        int consumers;
+        BenchResult mutex;
+        BenchResult mpmc;
+        BenchResult spsc;
+    };
+    QueueConfig configs[] = {
+        {"SPSC", 1, 1, {}, {}, {}},   // Single Producer Single Consumer
+        {"MPSC", 2, 1, {}, {}, {}},   // Multi Producer Single Consumer
+        {"SPMC", 1, 2, {}, {}, {}},   // Single Producer Multi Consumer
+        {"MPMC", num_producers, num_consumers, {}, {}, {}},
+    };
+    
+    for (QueueConfig& cfg : configs) {
+        cfg.mutex = run_benchmark(cfg.producers, cfg.consumers,
+                                  items_per_producer, test_duration);
+        cfg.mpmc = run_benchmark(cfg.producers, cfg.consumers,
+                                 items_per_producer, test_duration, RingImpl::MPMC);
+        if (cfg.producers == 1 && cfg.consumers == 1) {
+            cfg.spsc = run_benchmark(1, 1, items_per_producer, test_duration, RingImpl::SPSC);
+        }
+    }
+    
+    // Amortizar el lock: mismo anillo con mutex moviendo lotes de K elementos
+    // por adquisición (K = 1 es ring_push/ring_pop)
+    // (el K de --batch se agrega solo si no es uno de los predefinidos)
+    std::vector<int> batch_sizes = {1, 4, 16, 64, 256};
+    if (std::find(batch_sizes.begin(), batch_sizes.end(), batch_size) == batch_sizes.end()) {
+        batch_sizes.push_back(batch_size);
+        std::sort(batch_sizes.begin(), batch_sizes.end());
+    }
+    int num_batches = (int)batch_sizes.size();
+    std::vector<double> batch_throughput[2] = {std::vector<double>(num_batches),
+                                               std::vector<double>(num_batches)};
+    for (int b = 0; b < num_batches; b++) {
+        batch_throughput[0][b] = run_benchmark(1, 1, items_per_producer, test_duration,
+                                               RingImpl::MUTEX, batch_sizes[b]).throughput;
+        batch_throughput[1][b] = run_benchmark(num_producers, num_consumers, items_per_producer,
+                                               test_duration, RingImpl::MUTEX,
+                                               batch_sizes[b]).throughput;
+    }
+    
+    // Espera adaptativa: dormir de inmediato vs girar/ceder antes de dormir
+    struct WaitConfig {
+        const char* label;
+        WaitPolicy policy;
+        BenchResult result;
+    };
+    WaitConfig wait_configs[] = {
+        {"solo condvar",   {0, 0},     {}},
+        {"spin",           {1000, 0},  {}},
+        {"yield",          {0, 10},    {}},
+        {"spin+yield",     {user_wait.spin_iters, user_wait.yield_iters}, {}},
+    };
+    for (WaitConfig& cfg : wait_configs) {
+        cfg.result = run_benchmark(1, 1, items_per_producer, test_duration,
+                                   RingImpl::MUTEX, 1, cfg.policy);
+    }
+    
+    // Costo de despertar al consumidor: condvar vs eventfd sobre el MISMO
+    // Ring<Item> y el mismo aviso coalescido (solo cambia el mecanismo), con
+    // carga baja (el consumidor duerme entre elementos) y carga alta
+    // (productor sin pausas)
+    struct WakeupConfig {
+        const char* load;
+        const char* label;
+        RingImpl impl;
+        int items;
+        int delay_us;
+        BenchResult result;
+    };
+    int low_load_items = std::min(items_per_producer, 2000);
+    WakeupConfig wakeup_configs[] = {
+        {"baja", "condvar", RingImpl::SPSC_CONDVAR, low_load_items,     50, {}},
+        {"baja", "eventfd", RingImpl::SPSC_EVENTFD, low_load_items,     50, {}},
+        {"alta", "condvar", RingImpl::SPSC_CONDVAR, items_per_producer, 0,  {}},
+        {"alta", "eventfd", RingImpl::SPSC_EVENTFD, items_per_producer, 0,  {}},
+    };
+    for (WakeupConfig& cfg : wakeup_configs) {
+        cfg.result = run_benchmark(1, 1, cfg.items, test_duration, cfg.impl, 1,
+                                   WaitPolicy{}, g_layout, cfg.delay_us);
+    }
+    
+    // Costo de cruzar sockets: repetir 1P/1C con el consumidor en otro núcleo
+    // del MISMO socket que el productor y comparar
+    if (g_placement.policy == PlacementPolicy::CROSS_SOCKET) {
+        printf("\n=== COSTO ENTRE SOCKETS (1P/1C) ===\n");
+        double cross_throughput = run_benchmark(1, 1, items_per_producer, test_duration).throughput;
+        
+        ThreadPlacement cross_placement = g_placement;
+        g_placement.policy = PlacementPolicy::EXPLICIT;
+        g_placement.cpu_list = {placement_cpu_of(cross_placement, 0, 0),
+                                same_socket_peer(placement_cpu_of(cross_placement, 0, 0))};
+        double same_throughput = run_benchmark(1, 1, items_per_producer, test_duration).throughput;
+        g_placement = cross_placement;
+        
+        printf("\nMismo socket: %.2f items/seg\n", same_throughput);
+        printf("Entre sockets: %.2f items/seg (%.2fx más lento)\n",
+               cross_throughput, same_throughput / cross_throughput);
+    }
+    
+    printf("\n=== MUTEX VS SIN LOCKS (items/seg, latencia p99 en ns) ===\n");
+    printf("%-6s %-6s %12s %12s %12s %10s %10s %10s\n",
+           "Config", "P/C", "Mutex", "MPMC", "SPSC", "p99 Mutex", "p99 MPMC", "MPMC/Mutex");
+    for (const QueueConfig& cfg : configs) {
+        char pc[16];
+        snprintf(pc, sizeof(pc), "%d/%d", cfg.producers, cfg.consumers);
+        char spsc[16];
+        if (cfg.spsc.throughput > 0) {
+            snprintf(spsc, sizeof(spsc), "%.0f", cfg.spsc.throughput);
+        } else {
+            snprintf(spsc, sizeof(spsc), "-");
+        }
+        printf("%-6s %-6s %12.0f %12.0f %12s %10llu %10llu %9.2fx\n", cfg.label, pc,
+               cfg.mutex.throughput, cfg.mpmc.throughput, spsc,
+               (unsigned long long)cfg.mutex.p99_ns, (unsigned long long)cfg.mpmc.p99_ns,
+               cfg.mpmc.throughput / cfg.mutex.throughput);
+    }
+    
+    printf("\n=== LOTES CON MUTEX (items/seg) ===\n");
+    char pc_label[16];
+    snprintf(pc_label, sizeof(pc_label), "%dP/%dC", num_producers, num_consumers);
+    printf("%-6s %14s %8s %14s %8s\n", "Lote", "1P/1C", "vs K=1", pc_label, "vs K=1");
+    for (int b = 0; b < num_batches; b++) {
+        printf("%-6d %14.0f %7.2fx %14.0f %7.2fx\n", batch_sizes[b],
+               batch_throughput[0][b], batch_throughput[0][b] / batch_throughput[0][0],
+               batch_throughput[1][b], batch_throughput[1][b] / batch_throughput[1][0]);
+    }
+    
+    printf("\n=== ESPERA ADAPTATIVA, MUTEX 1P/1C (latencias en ns) ===\n");
+    printf("%-14s %7s %7s %12s %8s %8s %8s %9s %9s\n", "Política", "Spins", "Yields",
+           "Items/seg", "vs park", "p50", "p99", "p99.9", "max");
+    for (const WaitConfig& cfg : wait_configs) {
+        printf("%-14s %7d %7d %12.0f %7.2fx %8llu %8llu %9llu %9llu\n", cfg.label,
+               cfg.policy.spin_iters, cfg.policy.yield_iters, cfg.result.throughput,
+               cfg.result.throughput / wait_configs[0].result.throughput,
+               (unsigned long long)cfg.result.p50_ns, (unsigned long long)cfg.result.p99_ns,
+               (unsigned long long)cfg.result.p999_ns, (unsigned long long)cfg.result.max_ns);
+    }
+    
+    printf("\n=== DESPERTAR AL CONSUMIDOR, 1P/1C SPSC (latencias en ns) ===\n");
+    printf("%-6s %-9s %8s %12s %8s %8s %9s %12s %12s\n", "Carga", "Aviso", "Pausa us",
+           "Items/seg", "p50", "p99", "p99.9", "Sueños/1k", "Avisos/1k");
+    for (const WakeupConfig& cfg : wakeup_configs) {
+        double per_k = cfg.items > 0 ? 1000.0 / cfg.items : 0.0;
+        char writes[16];
+        if (cfg.result.notify_writes >= 0) {
+            snprintf(writes, sizeof(writes), "%.1f", cfg.result.notify_writes * per_k);
+        } else {
+            snprintf(writes, sizeof(writes), "-");
+        }
+        printf("%-6s %-9s %8d %12.0f %8llu %8llu %9llu %12.1f %12s\n", cfg.load, cfg.label,
+               cfg.delay_us, cfg.result.throughput,
+               (unsigned long long)cfg.result.p50_ns, (unsigned long long)cfg.result.p99_ns,
+               (unsigned long long)cfg.result.p999_ns, cfg.result.consumer_sleeps * per_k,
+               writes);
+    }
     
     printf("\n=== ANÁLISIS ===\n");
     printf("• SPSC: Máxima eficiencia, mínima contención\n");
+    printf("• SPSC sin locks: head/tail en líneas separadas, acquire/release en vez de mutex\n");
+    printf("• SPSC con Ring<T>: claim/commit y front/release, el registro no se copia al salir\n");
     printf("• MPSC: Contención en producción, consumo serial\n");
     printf("• SPMC: Producción serial, contención en consumo\n");
     printf("• MPMC: Máxima contención, pero máximo paralelismo\n");
+    printf("• Espera adaptativa: girar/ceder evita el futex si el otro lado llega pronto\n");
+    printf("• Lotes: un lock, dos memcpy y una notificación por K elementos\n");
+    printf("• MPMC sin locks: CAS sobre la posición + secuencia por celda, sin lock global\n");
+    printf("• eventfd coalescido: un write() solo si el consumidor se declaró dormido;\n");
+    printf("  el consumidor espera en epoll junto a sockets/timers en vez de pthread_cond_wait\n");
+    printf("• Aviso condvar vs eventfd: mismo Ring<T> y mismo protocolo, solo cambia la syscall\n");
     
     printf("\n=== PREGUNTAS GUÍA RESPONDIDAS ===\n");
     printf("• ¿Por qué while y no if? → Spurious wakeups y múltiples hilos\n");
@@ -13,11 +13,27 @@
 #include <cstdio>
 #include <cstdlib>
 #include <vector>
-#include <chrono>
 #include <cassert>
 #include <cstring>
 #include <unistd.h>
 #include <random>
+#include <sched.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include "cacheline.hpp"
+#include "cycle_clock.hpp"
+#include "ebr.hpp"
+#include "flat_hash_table.hpp"
+#include "key_distribution.hpp"
+#include "node_pool.hpp"
+#include "op_trace.hpp"
+#include "timing.hpp"
+#include "perf_counter.hpp"
+#include "rw_locks.hpp"
+#include "thread_affinity.hpp"
+#include "thread_pool.hpp"
 
 // ============================================================================
 // CONSTANTES Y CONFIGURACIÓN
@@ -26,6 +42,22 @@
 constexpr int NUM_BUCKETS = 1024;        // Número de buckets en la tabla hash
 constexpr int KEY_RANGE = 10000;         // Rango de claves posibles
 constexpr int INITIAL_ENTRIES = 500;     // Entradas iniciales en la tabla
+constexpr int DEFAULT_STRIPES = 64;      // Locks de StripedHashMap por defecto
+constexpr int HOLD_SAMPLE_EVERY = 64;    // 1 de cada N escrituras mide su sección crítica
+constexpr long DEFAULT_GROWTH_KEYS = 10000000;  // Claves del escenario de crecimiento
+constexpr int DEFAULT_SAMPLE_EVERY = 16; // 1 de cada N operaciones mide su latencia
+
+// Colocación de hilos seleccionada con --placement (por defecto: sin afinidad)
+static ThreadPlacement g_placement;
+
+// Hilos persistentes: crear/join hilos queda fuera de la región medida
+static ThreadPool g_pool;
+
+// Distribución de claves de los workers (--keys, por defecto uniforme)
+static KeyDistribution g_key_dist;
+
+// Muestreo de latencia por operación (--sample-every; 0 = desactivado)
+static int g_sample_every = DEFAULT_SAMPLE_EVERY;
 
 // ============================================================================
 // ESTRUCTURA DE NODO PARA HASH MAP
@@ -39,6 +71,34 @@ struct Node {
     Node(int k, int v) : key(k), value(v), next(nullptr) {}
 };
 
+/**
+ * Origen de los nodos de MutexHashMap / RWLockHashMap
+ *
+ * - HeapNodes: new/delete. put() llama a malloc con el lock global tomado,
+ *   así que el lock interno y la latencia de malloc alargan la sección crítica
+ * - PooledNodes: NodePool con KEY_RANGE nodos reservados al construir.
+ *   prepare(), llamada antes del lock, deja un nodo en la lista del hilo;
+ *   dentro del lock create() es sacar de esa lista
+ *
+ * En ambos casos remove() desengancha con el lock y destruye después.
+ */
+struct HeapNodes {
+    static constexpr const char* NAME = "new/delete";
+    
+    void prepare() {}
+    Node* create(int key, int value) { return new Node(key, value); }
+    void destroy(Node* node) { delete node; }
+};
+
+struct PooledNodes {
+    static constexpr const char* NAME = "pool por hilo";
+    NodePool<Node> pool{KEY_RANGE};
+    
+    void prepare() { pool.refill_local(); }
+    Node* create(int key, int value) { return pool.create(key, value); }
+    void destroy(Node* node) { pool.destroy(node); }
+};
+
 // ============================================================================
 // IMPLEMENTACIONES DE HASH MAP
 // ============================================================================
@@ -47,22 +107,48 @@ struct Node {
  * HashMap con pthread_mutex_t (exclusión mutua total)
  * Todas las operaciones son mutuamente excluyentes
  */
+template<typename NodeAlloc = HeapNodes>
 class MutexHashMap {
 private:
     Node* buckets[NUM_BUCKETS];
+    NodeAlloc nodes;
     pthread_mutex_t mutex;
     
     // Función hash simple
     int hash(int key) const {
         return ((unsigned int)key * 2654435761U) % NUM_BUCKETS;
     }
+    
+    uint64_t hold_begin() const {
+        return writes % HOLD_SAMPLE_EVERY == 0 ? now_ns() : 0;
+    }
+    
+    void hold_end(uint64_t start) {
+        if (start == 0) return;
+        write_hold_ns += (long)(now_ns() - start);
+        write_hold_samples++;
+    }
+    
+    /**
+     * Tomar el mutex; true si estaba ocupado (el trylock falló y hubo que
+     * esperar). El contador se suma después, ya con el lock tomado
+     */
+    bool lock_blocked() {
+        if (pthread_mutex_trylock(&mutex) == 0) return false;
+        pthread_mutex_lock(&mutex);
+        return true;
+    }
 
 public:
     // Estadísticas de monitoreo
     long reads = 0;
     long writes = 0;
-    long read_blocks = 0;
+    long read_blocks = 0;     // Operaciones que encontraron el lock ocupado
     long write_blocks = 0;
+    
+    // Tiempo con el lock de escritura tomado (muestreado; se suma con el lock)
+    long write_hold_ns = 0;
+    long write_hold_samples = 0;
 
     MutexHashMap() {
         memset(buckets, 0, sizeof(buckets));
@@ -75,7 +161,7 @@ public:
             Node* current = buckets[i];
             while (current) {
                 Node* next = current->next;
-                delete current;
+                nodes.destroy(current);
                 current = next;
             }
         }
@@ -87,7 +173,7 @@ public:
      * Con mutex, bloquea TODA la tabla incluso para lecturas
      */
     bool get(int key, int* value) {
-        pthread_mutex_lock(&mutex);  // BLOQUEO EXCLUSIVO TOTAL
+        if (lock_blocked()) read_blocks++;  // BLOQUEO EXCLUSIVO TOTAL
         reads++;
         
         int bucket_idx = hash(key);
@@ -111,8 +197,10 @@ public:
      * Insertar o actualizar clave-valor (operación de escritura)
      */
     void put(int key, int value) {
-        pthread_mutex_lock(&mutex);  // BLOQUEO EXCLUSIVO TOTAL
+        nodes.prepare();  // Fuera del lock: un pool puede reabastecer aquí
+        if (lock_blocked()) write_blocks++;  // BLOQUEO EXCLUSIVO TOTAL
         writes++;
+        uint64_t hold_start = hold_begin();
         
         int bucket_idx = hash(key);
         Node* current = buckets[bucket_idx];
@@ -121,6 +209,7 @@ public:
         while (current) {
             if (current->key == key) {
                 current->value = value;  // Actualizar valor existente
+                hold_end(hold_start);
                 pthread_mutex_unlock(&mutex);
                 return;
             }
@@ -128,10 +217,11 @@ public:
         }
         
         // Insertar nueva entrada al inicio de la lista
-        Node* new_node = new Node(key, value);
+        Node* new_node = nodes.create(key, value);
         new_node->next = buckets[bucket_idx];
         buckets[bucket_idx] = new_node;
         
+        hold_end(hold_start);
         pthread_mutex_unlock(&mutex);
     }
     
@@ -139,8 +229,9 @@ public:
      * Eliminar entrada por clave
      */
     bool remove(int key) {
-        pthread_mutex_lock(&mutex);
+        if (lock_blocked()) write_blocks++;
         writes++;
+        uint64_t hold_start = hold_begin();
         
         int bucket_idx = hash(key);
         Node* current = buckets[bucket_idx];
@@ -153,14 +244,16 @@ public:
                 } else {
                     buckets[bucket_idx] = current->next;
                 }
-                delete current;
+                hold_end(hold_start);
                 pthread_mutex_unlock(&mutex);
+                nodes.destroy(current);
                 return true;
             }
             prev = current;
             current = current->next;
         }
         
+        hold_end(hold_start);
         pthread_mutex_unlock(&mutex);
         return false;
     }
@@ -173,29 +266,68 @@ public:
 };
 
 /**
- * HashMap con pthread_rwlock_t (lectores concurrentes)
+ * HashMap con lock lector/escritor global (lectores concurrentes)
  * Múltiples lectores pueden acceder simultáneamente
  * Escritores tienen acceso exclusivo
+ * RWLock es cualquier lock de rw_locks.hpp (por defecto pthread_rwlock_t)
  */
+template<typename NodeAlloc = HeapNodes, typename RWLock = PthreadRWLock>
 class RWLockHashMap {
 private:
     Node* buckets[NUM_BUCKETS];
-    pthread_rwlock_t rwlock;
+    NodeAlloc nodes;
+    RWLock rwlock;
     
     int hash(int key) const {
         return ((unsigned int)key * 2654435761U) % NUM_BUCKETS;
     }
+    
+    uint64_t hold_begin() const {
+        return writes % HOLD_SAMPLE_EVERY == 0 ? now_ns() : 0;
+    }
+    
+    void hold_end(uint64_t start) {
+        if (start == 0) return;
+        write_hold_ns += (long)(now_ns() - start);
+        write_hold_samples++;
+    }
+    
+    // Tomar el lock de lectura / escritura; true si el try* falló y hubo que esperar
+    bool rdlock_blocked() {
+        if (rwlock.try_lock_shared()) return false;
+        rwlock.lock_shared();
+        return true;
+    }
+    
+    // La espera de un escritor bloqueado se mide siempre (es el caso raro)
+    // y se suma ya con el lock exclusivo tomado
+    bool wrlock_blocked() {
+        if (rwlock.try_lock()) return false;
+        uint64_t wait_start = now_ns();
+        rwlock.lock();
+        long waited = (long)(now_ns() - wait_start);
+        write_wait_ns += waited;
+        if (waited > write_wait_max_ns) write_wait_max_ns = waited;
+        return true;
+    }
 
 public:
-    // Estadísticas de monitoreo
-    long reads = 0;
+    // Estadísticas de monitoreo (las lecturas las cuenta cada hilo: un
+    // contador aquí se sumaría con el lock compartido y rebotaría su línea)
     long writes = 0;
-    long read_blocks = 0;
+    std::atomic<long> read_blocks{0};   // Atómico: se suma con el lock compartido
     long write_blocks = 0;
+    
+    // Tiempo con el lock de escritura tomado (muestreado; se suma con el lock)
+    long write_hold_ns = 0;
+    long write_hold_samples = 0;
+    
+    // Espera de escritores por el lock (write_blocks esperas en total)
+    long write_wait_ns = 0;
+    long write_wait_max_ns = 0;
 
     RWLockHashMap() {
         memset(buckets, 0, sizeof(buckets));
-        pthread_rwlock_init(&rwlock, nullptr);
     }
     
     ~RWLockHashMap() {
@@ -203,11 +335,10 @@ public:
             Node* current = buckets[i];
             while (current) {
                 Node* next = current->next;
-                delete current;
+                nodes.destroy(current);
                 current = next;
             }
         }
-        pthread_rwlock_destroy(&rwlock);
     }
     
     /**
@@ -215,8 +346,9 @@ public:
      * Usa READ LOCK - permite múltiples lectores concurrentes
      */
     bool get(int key, int* value) {
-        pthread_rwlock_rdlock(&rwlock);  // BLOQUEO COMPARTIDO PARA LECTURA
-        reads++;
+        if (rdlock_blocked()) {  // BLOQUEO COMPARTIDO PARA LECTURA
+            read_blocks.fetch_add(1, std::memory_order_relaxed);
+        }
         
         int bucket_idx = hash(key);
         Node* current = buckets[bucket_idx];
@@ -224,13 +356,13 @@ public:
         while (current) {
             if (current->key == key) {
                 *value = current->value;
-                pthread_rwlock_unlock(&rwlock);
+                rwlock.unlock_shared();
                 return true;
             }
             current = current->next;
         }
         
-        pthread_rwlock_unlock(&rwlock);
+        rwlock.unlock_shared();
         return false;
     }
     
@@ -239,8 +371,10 @@ public:
      * Usa WRITE LOCK - acceso exclusivo total
      */
     void put(int key, int value) {
-        pthread_rwlock_wrlock(&rwlock);  // BLOQUEO EXCLUSIVO PARA ESCRITURA
+        nodes.prepare();  // Fuera del lock: un pool puede reabastecer aquí
+        if (wrlock_blocked()) write_blocks++;  // BLOQUEO EXCLUSIVO PARA ESCRITURA
         writes++;
+        uint64_t hold_start = hold_begin();
         
         int bucket_idx = hash(key);
         Node* current = buckets[bucket_idx];
@@ -249,26 +383,29 @@ public:
         while (current) {
             if (current->key == key) {
                 current->value = value;
-                pthread_rwlock_unlock(&rwlock);
+                hold_end(hold_start);
+                rwlock.unlock();
                 return;
             }
             current = current->next;
         }
         
         // Insertar nueva entrada
-        Node* new_node = new Node(key, value);
+        Node* new_node = nodes.create(key, value);
         new_node->next = buckets[bucket_idx];
         buckets[bucket_idx] = new_node;
         
-        pthread_rwlock_unlock(&rwlock);
+        hold_end(hold_start);
+        rwlock.unlock();
     }
     
     /**
      * Eliminar entrada por clave
      */
     bool remove(int key) {
-        pthread_rwlock_wrlock(&rwlock);  // BLOQUEO EXCLUSIVO
+        if (wrlock_blocked()) write_blocks++;  // BLOQUEO EXCLUSIVO
         writes++;
+        uint64_t hold_start = hold_begin();
         
         int bucket_idx = hash(key);
         Node* current = buckets[bucket_idx];
@@ -281,185 +418,1941 @@ public:
                 } else {
                     buckets[bucket_idx] = current->next;
                 }
-                delete current;
-                pthread_rwlock_unlock(&rwlock);
+                hold_end(hold_start);
+                rwlock.unlock();
+                nodes.destroy(current);
                 return true;
             }
             prev = current;
             current = current->next;
         }
         
-        pthread_rwlock_unlock(&rwlock);
+        hold_end(hold_start);
+        rwlock.unlock();
         return false;
     }
     
     void get_stats(long* r, long* w, long* rb, long* wb) {
-        pthread_rwlock_rdlock(&rwlock);
-        *r = reads; *w = writes; *rb = read_blocks; *wb = write_blocks;
-        pthread_rwlock_unlock(&rwlock);
+        rwlock.lock_shared();
+        *r = 0;  // Las lecturas se cuentan por hilo
+        *w = writes; *rb = read_blocks; *wb = write_blocks;
+        rwlock.unlock_shared();
     }
 };
 
 // ============================================================================
-// HILOS WORKER PARA BENCHMARKS
+// HASHMAP CON BIG-READER LOCK (BRLOCK)
 // ============================================================================
 
-struct WorkerArgs {
-    void* hashmap;           // Puntero a MutexHashMap o RWLockHashMap
-    bool is_rwlock;          // true si es RWLockHashMap, false si es MutexHashMap
-    int thread_id;
-    long operations;
-    int read_percentage;     // 90 = 90% lecturas, 10% escrituras
-    std::mt19937* rng;       // Generador de números aleatorios
+/**
+ * RWLockHashMap con lock global de lectores distribuidos (BigReaderRWLock)
+ *
+ * Con pthread_rwlock_t cada lectura escribe el contador de lectores del
+ * lock: con N núcleos leyendo, esa línea rebota entre todos aunque los
+ * lectores nunca entren en conflicto. Con BigReaderRWLock cada hilo escribe
+ * solo su slot (y las lecturas se cuentan por hilo), así que una lectura
+ * sin escritores no toca ninguna línea compartida y escala casi
+ * linealmente. A cambio cada escritura recorre los slots de todos los hilos
+ */
+typedef RWLockHashMap<HeapNodes, BigReaderRWLock> BrlockHashMap;
+
+// ============================================================================
+// LOCKS POR FRANJA
+// ============================================================================
+
+/**
+ * Locks intercambiables para StripedHashMap. Todos exponen
+ * lock/unlock (escritura) y lock_shared/unlock_shared (lectura), con su
+ * try_* que no espera; los que no distinguen lectores usan el lock
+ * exclusivo para ambos
+ */
+struct StripeMutex {
+    static constexpr const char* NAME = "mutex";
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    
+    ~StripeMutex() { pthread_mutex_destroy(&mutex); }
+    void lock() { pthread_mutex_lock(&mutex); }
+    void unlock() { pthread_mutex_unlock(&mutex); }
+    bool try_lock() { return pthread_mutex_trylock(&mutex) == 0; }
+    void lock_shared() { lock(); }
+    void unlock_shared() { unlock(); }
+    bool try_lock_shared() { return try_lock(); }
+};
+
+struct StripeRWLock {
+    static constexpr const char* NAME = "rwlock";
+    pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+    
+    ~StripeRWLock() { pthread_rwlock_destroy(&rwlock); }
+    void lock() { pthread_rwlock_wrlock(&rwlock); }
+    void unlock() { pthread_rwlock_unlock(&rwlock); }
+    bool try_lock() { return pthread_rwlock_trywrlock(&rwlock) == 0; }
+    void lock_shared() { pthread_rwlock_rdlock(&rwlock); }
+    void unlock_shared() { pthread_rwlock_unlock(&rwlock); }
+    bool try_lock_shared() { return pthread_rwlock_tryrdlock(&rwlock) == 0; }
 };
 
 /**
- * Worker thread que ejecuta mezcla de operaciones de lectura/escritura
+ * Spinlock test-and-test-and-set: gira leyendo (sin escribir la línea)
+ * y solo intenta el exchange cuando lo ve libre. Cede el núcleo tras unos
+ * reintentos para no quitarle la CPU al dueño del lock
  */
-void* worker_thread(void* arg) {
-    WorkerArgs* args = static_cast<WorkerArgs*>(arg);
-    std::uniform_int_distribution<int> key_dist(0, KEY_RANGE - 1);
-    std::uniform_int_distribution<int> op_dist(0, 99);  // 0-99 para porcentajes
-    std::uniform_int_distribution<int> val_dist(1, 1000);
+struct StripeSpinLock {
+    static constexpr const char* NAME = "spinlock";
+    std::atomic<bool> locked{false};
     
-    for (long i = 0; i < args->operations; i++) {
-        int key = key_dist(*args->rng);
-        bool is_read = op_dist(*args->rng) < args->read_percentage;
-        
-        if (is_read) {
-            // Operación de lectura
-            int value;
-            if (args->is_rwlock) {
-                static_cast<RWLockHashMap*>(args->hashmap)->get(key, &value);
-            } else {
-                static_cast<MutexHashMap*>(args->hashmap)->get(key, &value);
+    void lock() {
+        for (int spins = 0; ; spins++) {
+            if (!locked.load(std::memory_order_relaxed) &&
+                !locked.exchange(true, std::memory_order_acquire)) {
+                return;
             }
-        } else {
-            // Operación de escritura (inserción/actualización)
-            int value = val_dist(*args->rng);
-            if (args->is_rwlock) {
-                static_cast<RWLockHashMap*>(args->hashmap)->put(key, value);
+            if (spins < 64) {
+                cpu_relax();
             } else {
-                static_cast<MutexHashMap*>(args->hashmap)->put(key, value);
+                sched_yield();
             }
         }
     }
-    
-    return nullptr;
+    void unlock() { locked.store(false, std::memory_order_release); }
+    bool try_lock() {
+        return !locked.load(std::memory_order_relaxed) &&
+               !locked.exchange(true, std::memory_order_acquire);
+    }
+    void lock_shared() { lock(); }
+    void unlock_shared() { unlock(); }
+    bool try_lock_shared() { return try_lock(); }
+};
+
+/**
+ * Tomar el lock de una franja; true si el try* falló y hubo que esperar
+ * (la misma medida de contención que MutexHashMap / RWLockHashMap)
+ */
+template<typename StripeLock>
+bool stripe_lock_blocked(StripeLock& lock) {
+    if (lock.try_lock()) return false;
+    lock.lock();
+    return true;
 }
 
-// ============================================================================
-// FUNCIONES DE BENCHMARK
-// ============================================================================
+template<typename StripeLock>
+bool stripe_lock_shared_blocked(StripeLock& lock) {
+    if (lock.try_lock_shared()) return false;
+    lock.lock_shared();
+    return true;
+}
 
-template<typename HashMap>
-double benchmark_hashmap(const char* name, HashMap* map, bool is_rwlock,
-                        int num_threads, long ops_per_thread, int read_pct) {
+/**
+ * HashMap con un lock por franja de buckets (lock striping)
+ *
+ * Los NUM_BUCKETS se reparten en num_stripes rangos contiguos y cada rango
+ * tiene su propio lock (StripeLock). Operaciones sobre franjas distintas no
+ * se bloquean entre sí, así que la contención baja ~num_stripes veces.
+ * Cada franja ocupa su propia línea de caché (lock + contadores) para que
+ * tomar un lock no invalide el de la franja vecina.
+ */
+template<typename StripeLock>
+class StripedHashMap {
+private:
+    struct alignas(CACHE_LINE_SIZE) Stripe {
+        StripeLock lock;
+        std::atomic<long> reads{0};   // Atómicos: varios lectores con rwlock
+        std::atomic<long> writes{0};
+        std::atomic<long> read_blocks{0};   // Operaciones que encontraron el lock ocupado
+        std::atomic<long> write_blocks{0};
+    };
     
-    printf("\n--- Benchmarking %s (R/W: %d/%d%%) ---\n", 
-           name, read_pct, 100 - read_pct);
+    Node* buckets[NUM_BUCKETS];
+    std::vector<Stripe> stripes;
     
-    std::vector<pthread_t> threads(num_threads);
-    std::vector<WorkerArgs> args(num_threads);
-    std::vector<std::mt19937> rngs(num_threads);
+    int hash(int key) const {
+        return ((unsigned int)key * 2654435761U) % NUM_BUCKETS;
+    }
     
-    // Inicializar generadores de números aleatorios con diferentes semillas
-    for (int i = 0; i < num_threads; i++) {
-        rngs[i].seed(42 + i);  // Semillas diferentes pero reproducibles
+    Stripe& stripe_of(int bucket_idx) {
+        return stripes[(std::size_t)bucket_idx * stripes.size() / NUM_BUCKETS];
+    }
+
+public:
+    explicit StripedHashMap(int num_stripes = DEFAULT_STRIPES)
+        : stripes(num_stripes < 1 ? 1 : num_stripes > NUM_BUCKETS ? NUM_BUCKETS : num_stripes) {
+        memset(buckets, 0, sizeof(buckets));
     }
     
-    auto start = std::chrono::high_resolution_clock::now();
+    ~StripedHashMap() {
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            Node* current = buckets[i];
+            while (current) {
+                Node* next = current->next;
+                delete current;
+                current = next;
+            }
+        }
+    }
     
-    // Crear hilos trabajadores
-    for (int i = 0; i < num_threads; i++) {
-        args[i] = {
-            .hashmap = map,
-            .is_rwlock = is_rwlock,
-            .thread_id = i,
-            .operations = ops_per_thread,
-            .read_percentage = read_pct,
-            .rng = &rngs[i]
-        };
+    int num_stripes() const { return (int)stripes.size(); }
+    
+    /**
+     * Buscar valor por clave: lock de lectura solo sobre la franja del bucket
+     */
+    bool get(int key, int* value) {
+        int bucket_idx = hash(key);
+        Stripe& stripe = stripe_of(bucket_idx);
+        if (stripe_lock_shared_blocked(stripe.lock)) {
+            stripe.read_blocks.fetch_add(1, std::memory_order_relaxed);
+        }
+        stripe.reads.fetch_add(1, std::memory_order_relaxed);
+        
+        for (Node* current = buckets[bucket_idx]; current; current = current->next) {
+            if (current->key == key) {
+                *value = current->value;
+                stripe.lock.unlock_shared();
+                return true;
+            }
+        }
         
-        pthread_create(&threads[i], nullptr, worker_thread, &args[i]);
+        stripe.lock.unlock_shared();
+        return false;
     }
     
-    // Esperar terminación
-    for (int i = 0; i < num_threads; i++) {
-        pthread_join(threads[i], nullptr);
+    /**
+     * Insertar o actualizar clave-valor: lock exclusivo de la franja
+     */
+    void put(int key, int value) {
+        int bucket_idx = hash(key);
+        Stripe& stripe = stripe_of(bucket_idx);
+        if (stripe_lock_blocked(stripe.lock)) {
+            stripe.write_blocks.fetch_add(1, std::memory_order_relaxed);
+        }
+        stripe.writes.fetch_add(1, std::memory_order_relaxed);
+        
+        for (Node* current = buckets[bucket_idx]; current; current = current->next) {
+            if (current->key == key) {
+                current->value = value;
+                stripe.lock.unlock();
+                return;
+            }
+        }
+        
+        Node* new_node = new Node(key, value);
+        new_node->next = buckets[bucket_idx];
+        buckets[bucket_idx] = new_node;
+        
+        stripe.lock.unlock();
     }
     
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration<double>(end - start).count();
-    
-    // Obtener estadísticas
-    long reads, writes, read_blocks, write_blocks;
-    map->get_stats(&reads, &writes, &read_blocks, &write_blocks);
-    
-    long total_ops = reads + writes;
-    double throughput = total_ops / duration;
+    /**
+     * Eliminar entrada por clave
+     */
+    bool remove(int key) {
+        int bucket_idx = hash(key);
+        Stripe& stripe = stripe_of(bucket_idx);
+        if (stripe_lock_blocked(stripe.lock)) {
+            stripe.write_blocks.fetch_add(1, std::memory_order_relaxed);
+        }
+        stripe.writes.fetch_add(1, std::memory_order_relaxed);
+        
+        Node* prev = nullptr;
+        for (Node* current = buckets[bucket_idx]; current; current = current->next) {
+            if (current->key == key) {
+                if (prev) {
+                    prev->next = current->next;
+                } else {
+                    buckets[bucket_idx] = current->next;
+                }
+                delete current;
+                stripe.lock.unlock();
+                return true;
+            }
+            prev = current;
+        }
+        
+        stripe.lock.unlock();
+        return false;
+    }
     
-    printf("Tiempo: %.4f seg\n", duration);
-    printf("Operaciones totales: %ld (R: %ld, W: %ld)\n", total_ops, reads, writes);
-    printf("Throughput: %.2f ops/seg\n", throughput);
-    printf("Proporción real R/W: %.1f%%/%.1f%%\n", 
-           100.0 * reads / total_ops, 100.0 * writes / total_ops);
+    void get_stats(long* r, long* w, long* rb, long* wb) {
+        *r = 0;
+        *w = 0;
+        *rb = 0;
+        *wb = 0;
+        for (Stripe& stripe : stripes) {
+            *r += stripe.reads.load(std::memory_order_relaxed);
+            *w += stripe.writes.load(std::memory_order_relaxed);
+            *rb += stripe.read_blocks.load(std::memory_order_relaxed);
+            *wb += stripe.write_blocks.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+// ============================================================================
+// HASHMAP CON SEQLOCK POR BUCKET
+// ============================================================================
+
+/**
+ * Nodo leído sin lock: todos sus campos son atómicos para que un lector
+ * concurrente con un escritor no sea una data race (se leen con relaxed y
+ * el seqlock decide si el resultado vale)
+ */
+struct SeqNode {
+    std::atomic<int> key;
+    std::atomic<int> value;
+    std::atomic<SeqNode*> next;
     
-    return throughput;
-}
+    SeqNode(int k, int v, SeqNode* n) : key(k), value(v), next(n) {}
+};
 
 /**
- * Poblar el hashmap con datos iniciales
+ * HashMap con un seqlock por bucket: get() nunca escribe memoria compartida
+ *
+ * Cada bucket tiene un contador de secuencia (par = estable, impar =
+ * escritor dentro). El escritor lo pasa a impar con CAS (así también se
+ * excluyen los escritores del mismo bucket), modifica y lo devuelve a par.
+ * El lector lee la secuencia, recorre la lista sin lock y vuelve a leerla:
+ * si cambió o era impar, reintenta. Las lecturas solo comparten la línea
+ * del bucket en estado Shared, así que escalan con los núcleos mientras no
+ * haya escrituras en el mismo bucket.
+ *
+ * Un lector puede estar recorriendo un nodo que otro hilo acaba de quitar:
+ * get() recorre dentro de una sección de época (escribe solo su propio
+ * slot) y remove() entrega el nodo a EbrDomain::retire, que lo libera tras
+ * un periodo de gracia. La memoria queda acotada con cualquier mezcla de
+ * remove(), como en RcuHashMap.
  */
-template<typename HashMap>
-void populate_hashmap(HashMap* map, int num_entries) {
-    std::mt19937 rng(42);  // Semilla fija para reproducibilidad
-    std::uniform_int_distribution<int> key_dist(0, KEY_RANGE - 1);
-    std::uniform_int_distribution<int> val_dist(1, 1000);
+class SeqlockHashMap {
+private:
+    struct alignas(CACHE_LINE_SIZE) Bucket {
+        std::atomic<unsigned> seq{0};
+        std::atomic<SeqNode*> head{nullptr};
+    };
     
-    for (int i = 0; i < num_entries; i++) {
-        int key = key_dist(rng);
-        int value = val_dist(rng);
-        map->put(key, value);
+    // Cota de pasos por recorrido: una lectura inconsistente puede seguir
+    // punteros de una lista en cambio; se corta y se reintenta
+    static constexpr int MAX_CHAIN_STEPS = 1 << 16;
+    
+    Bucket buckets[NUM_BUCKETS];
+    EbrDomain ebr;
+    
+    int hash(int key) const {
+        return ((unsigned int)key * 2654435761U) % NUM_BUCKETS;
+    }
+    
+    /**
+     * Tomar el bucket para escribir: secuencia par -> impar
+     */
+    void write_begin(Bucket& bucket) {
+        for (int spins = 0; ; spins++) {
+            unsigned seq = bucket.seq.load(std::memory_order_relaxed);
+            if ((seq & 1) == 0 &&
+                bucket.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire)) {
+                // Las escrituras de datos no pueden verse antes de la secuencia impar
+                std::atomic_thread_fence(std::memory_order_release);
+                return;
+            }
+            if (spins < 64) {
+                cpu_relax();
+            } else {
+                sched_yield();
+            }
+        }
+    }
+    
+    void write_end(Bucket& bucket) {
+        bucket.seq.fetch_add(1, std::memory_order_release);  // Impar -> par
     }
-}
 
-// ============================================================================
-// FUNCIÓN PRINCIPAL
-// ============================================================================
+public:
+    // Estadísticas: escrituras y reintentos de lectura (solo se escriben en
+    // el camino raro, no en cada get)
+    std::atomic<long> writes{0};
+    std::atomic<long> read_retries{0};
 
-int main(int argc, char** argv) {
-    printf("=== LABORATORIO 6 - PRÁCTICA 3: LECTORES/ESCRITORES ===\n");
+    SeqlockHashMap() = default;
     
-    // Parámetros configurables
-    int num_threads = (argc > 1) ? std::atoi(argv[1]) : 4;
-    long ops_per_thread = (argc > 2) ? std::atol(argv[2]) : 100000;
-    
-    printf("Configuración: %d hilos, %ld ops/hilo\n", num_threads, ops_per_thread);
-    printf("Buckets: %d, Rango de claves: %d\n", NUM_BUCKETS, KEY_RANGE);
+    ~SeqlockHashMap() {
+        for (Bucket& bucket : buckets) {
+            SeqNode* current = bucket.head.load(std::memory_order_relaxed);
+            while (current) {
+                SeqNode* next = current->next.load(std::memory_order_relaxed);
+                delete current;
+                current = next;
+            }
+        }
+    }
     
-    // Diferentes proporciones de lectura/escritura para probar
-    std::vector<int> read_percentages = {90, 70, 50, 30, 10};
+    SeqlockHashMap(const SeqlockHashMap&) = delete;
+    SeqlockHashMap& operator=(const SeqlockHashMap&) = delete;
     
-    printf("\n=== COMPARACIÓN MUTEX vs RWLOCK ===\n");
+    /**
+     * Lectura optimista: sin locks ni escrituras a memoria compartida
+     * (la época se publica en el slot propio del hilo)
+     */
+    bool get(int key, int* value) {
+        Bucket& bucket = buckets[hash(key)];
+        EbrGuard guard(ebr);
+        for (;;) {
+            unsigned seq_before = bucket.seq.load(std::memory_order_acquire);
+            if (seq_before & 1) {
+                cpu_relax();  // Escritor dentro: esperar a que termine
+                continue;
+            }
+            
+            bool found = false;
+            int result = 0;
+            int steps = 0;
+            for (SeqNode* current = bucket.head.load(std::memory_order_acquire);
+                 current && steps < MAX_CHAIN_STEPS;
+                 current = current->next.load(std::memory_order_acquire), steps++) {
+                if (current->key.load(std::memory_order_relaxed) == key) {
+                    result = current->value.load(std::memory_order_relaxed);
+                    found = true;
+                    break;
+                }
+            }
+            
+            // Las lecturas de datos no pueden moverse después de releer seq
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (bucket.seq.load(std::memory_order_relaxed) == seq_before &&
+                steps < MAX_CHAIN_STEPS) {
+                if (found) *value = result;
+                return found;
+            }
+            read_retries.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
     
-        for (int read_pct : read_percentages) {
-        printf("\n============================================================\n");
-        printf("PROPORCIÓN: %d%% LECTURAS, %d%% ESCRITURAS\n", read_pct, 100 - read_pct);
-        printf("============================================================\n");
+    /**
+     * Insertar o actualizar: incrementa la secuencia del bucket
+     */
+    void put(int key, int value) {
+        Bucket& bucket = buckets[hash(key)];
+        write_begin(bucket);
+        writes.fetch_add(1, std::memory_order_relaxed);
         
-        // Test con Mutex HashMap
-        MutexHashMap mutex_map;
-        populate_hashmap(&mutex_map, INITIAL_ENTRIES);
-        double mutex_throughput = benchmark_hashmap("Mutex HashMap", &mutex_map, false,
-                                                   num_threads, ops_per_thread, read_pct);
+        for (SeqNode* current = bucket.head.load(std::memory_order_relaxed); current;
+             current = current->next.load(std::memory_order_relaxed)) {
+            if (current->key.load(std::memory_order_relaxed) == key) {
+                current->value.store(value, std::memory_order_relaxed);
+                write_end(bucket);
+                return;
+            }
+        }
         
-        // Test con RWLock HashMap  
-        RWLockHashMap rwlock_map;
-        populate_hashmap(&rwlock_map, INITIAL_ENTRIES);
-        double rwlock_throughput = benchmark_hashmap("RWLock HashMap", &rwlock_map, true,
+        // Publicar el nodo ya inicializado
+        SeqNode* new_node = new SeqNode(key, value, bucket.head.load(std::memory_order_relaxed));
+        bucket.head.store(new_node, std::memory_order_release);
+        
+        write_end(bucket);
+    }
+    
+    /**
+     * Eliminar entrada: se desengancha y se retira (se libera cuando ningún
+     * lector pueda seguir recorriéndolo)
+     */
+    bool remove(int key) {
+        Bucket& bucket = buckets[hash(key)];
+        write_begin(bucket);
+        writes.fetch_add(1, std::memory_order_relaxed);
+        
+        std::atomic<SeqNode*>* link = &bucket.head;
+        for (SeqNode* current = link->load(std::memory_order_relaxed); current;
+             current = link->load(std::memory_order_relaxed)) {
+            if (current->key.load(std::memory_order_relaxed) == key) {
+                link->store(current->next.load(std::memory_order_relaxed),
+                            std::memory_order_release);
+                write_end(bucket);
+                ebr.retire(current);
+                return true;
+            }
+            link = &current->next;
+        }
+        
+        write_end(bucket);
+        return false;
+    }
+    
+    EbrStats reclamation_stats() const { return ebr.stats(); }
+    
+    void get_stats(long* r, long* w, long* rb, long* wb) {
+        *r = 0;  // Las lecturas no se cuentan aquí para no escribir memoria compartida
+        *w = writes.load(std::memory_order_relaxed);
+        // Sin bloqueos: los lectores no toman lock (su contención son los
+        // reintentos) y los escritores giran sobre la secuencia del bucket
+        *rb = 0;
+        *wb = 0;
+    }
+};
+
+// ============================================================================
+// HASHMAP RCU CON RECLAMACIÓN POR ÉPOCAS
+// ============================================================================
+
+/**
+ * Nodo inmutable una vez publicado (salvo next): actualizar un valor
+ * publica una copia nueva y retira la vieja, al estilo RCU
+ */
+struct RcuNode {
+    const int key;
+    const int value;
+    std::atomic<RcuNode*> next;
+    
+    RcuNode(int k, int v, RcuNode* n) : key(k), value(v), next(n) {}
+};
+
+/**
+ * HashMap con lectores sin locks y liberación diferida (EBR)
+ *
+ * - get(): entra a una sección de época (escribe solo su propio slot),
+ *   recorre next con loads acquire y sale. Nunca espera ni reintenta
+ * - put()/remove(): spinlock por bucket entre escritores; cambian la lista
+ *   publicando punteros con release y entregan los nodos que quitaron a
+ *   EbrDomain::retire, que los libera cuando pasó un periodo de gracia
+ * - Actualizar una clave reemplaza el nodo (copy-update), así un lector
+ *   nunca ve un nodo a medio modificar y el benchmark, que solo hace
+ *   get/put, sí ejercita la reclamación
+ */
+class RcuHashMap {
+private:
+    struct alignas(CACHE_LINE_SIZE) Bucket {
+        std::atomic<RcuNode*> head{nullptr};
+        StripeSpinLock writer_lock;
+    };
+    
+    Bucket buckets[NUM_BUCKETS];
+    EbrDomain ebr;
+    
+    int hash(int key) const {
+        return ((unsigned int)key * 2654435761U) % NUM_BUCKETS;
+    }
+
+public:
+    std::atomic<long> writes{0};
+    std::atomic<long> live_nodes{0};
+
+    RcuHashMap() = default;
+    
+    ~RcuHashMap() {
+        for (Bucket& bucket : buckets) {
+            RcuNode* current = bucket.head.load(std::memory_order_relaxed);
+            while (current) {
+                RcuNode* next = current->next.load(std::memory_order_relaxed);
+                delete current;
+                current = next;
+            }
+        }
+        // ebr libera lo retirado pendiente en su destructor
+    }
+    
+    RcuHashMap(const RcuHashMap&) = delete;
+    RcuHashMap& operator=(const RcuHashMap&) = delete;
+    
+    /**
+     * Lectura wait-free: sin locks, sin reintentos
+     */
+    bool get(int key, int* value) {
+        EbrGuard guard(ebr);
+        for (RcuNode* current = buckets[hash(key)].head.load(std::memory_order_acquire);
+             current; current = current->next.load(std::memory_order_acquire)) {
+            if (current->key == key) {
+                *value = current->value;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    /**
+     * Insertar, o reemplazar el nodo de la clave por una copia con el valor nuevo
+     */
+    void put(int key, int value) {
+        Bucket& bucket = buckets[hash(key)];
+        RcuNode* old_node = nullptr;
+        
+        bucket.writer_lock.lock();
+        writes.fetch_add(1, std::memory_order_relaxed);
+        std::atomic<RcuNode*>* link = &bucket.head;
+        for (RcuNode* current = link->load(std::memory_order_relaxed); current;
+             current = link->load(std::memory_order_relaxed)) {
+            if (current->key == key) {
+                old_node = current;
+                break;
+            }
+            link = &current->next;
+        }
+        
+        if (old_node) {
+            RcuNode* copy = new RcuNode(key, value, old_node->next.load(std::memory_order_relaxed));
+            link->store(copy, std::memory_order_release);
+        } else {
+            RcuNode* new_node = new RcuNode(key, value, bucket.head.load(std::memory_order_relaxed));
+            bucket.head.store(new_node, std::memory_order_release);
+            live_nodes.fetch_add(1, std::memory_order_relaxed);
+        }
+        bucket.writer_lock.unlock();
+        
+        // Fuera del lock: los lectores que lo tengan lo siguen viendo válido
+        if (old_node) ebr.retire(old_node);
+    }
+    
+    /**
+     * Eliminar: desenganchar bajo el lock del bucket y retirar el nodo
+     */
+    bool remove(int key) {
+        Bucket& bucket = buckets[hash(key)];
+        RcuNode* removed = nullptr;
+        
+        bucket.writer_lock.lock();
+        writes.fetch_add(1, std::memory_order_relaxed);
+        std::atomic<RcuNode*>* link = &bucket.head;
+        for (RcuNode* current = link->load(std::memory_order_relaxed); current;
+             current = link->load(std::memory_order_relaxed)) {
+            if (current->key == key) {
+                link->store(current->next.load(std::memory_order_relaxed),
+                            std::memory_order_release);
+                removed = current;
+                break;
+            }
+            link = &current->next;
+        }
+        bucket.writer_lock.unlock();
+        
+        if (!removed) return false;
+        live_nodes.fetch_sub(1, std::memory_order_relaxed);
+        ebr.retire(removed);
+        return true;
+    }
+    
+    EbrStats reclamation_stats() const { return ebr.stats(); }
+    
+    void get_stats(long* r, long* w, long* rb, long* wb) {
+        *r = 0;  // Las lecturas no escriben memoria compartida
+        *w = writes.load(std::memory_order_relaxed);
+        // Sin bloqueos de lectura (no hay lock); el spinlock de escritor es
+        // por bucket y con NUM_BUCKETS buckets casi nunca se disputa
+        *rb = 0;
+        *wb = 0;
+    }
+};
+
+// ============================================================================
+// HASHMAP PLANO (DIRECCIONAMIENTO ABIERTO) CON LOCKS
+// ============================================================================
+
+/**
+ * FlatHashTable envuelta con los mismos locks que los mapas encadenados
+ *
+ * Con direccionamiento abierto una clave puede quedar en cualquier grupo de
+ * la tabla, así que no se puede asignar un lock a un rango de buckets: se
+ * parte el mapa en num_shards tablas independientes, cada una con su lock
+ * (StripeLock) en su propia línea de caché. Con 1 shard es el equivalente
+ * plano de MutexHashMap / RWLockHashMap; con N, de StripedHashMap.
+ */
+template<typename StripeLock>
+class FlatHashMap {
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        StripeLock lock;
+        std::atomic<long> reads{0};
+        std::atomic<long> writes{0};
+        std::atomic<long> read_blocks{0};   // Operaciones que encontraron el lock ocupado
+        std::atomic<long> write_blocks{0};
+        FlatHashTable table;
+    };
+    
+    std::vector<Shard> shards;
+    
+    // Bits altos del hash multiplicativo (la tabla usa su propia mezcla)
+    Shard& shard_of(int key) {
+        uint32_t h = (unsigned int)key * 2654435761U;
+        return shards[((uint64_t)h * shards.size()) >> 32];
+    }
+
+public:
+    explicit FlatHashMap(int num_shards = 1)
+        : shards(num_shards < 1 ? 1 : num_shards > NUM_BUCKETS ? NUM_BUCKETS : num_shards) {
+        // Cada shard recibe ~1/N de las claves: espacio para todas sin rehacer
+        for (Shard& shard : shards) shard.table.reserve(KEY_RANGE / shards.size() + KEY_RANGE / 8);
+    }
+    
+    int num_shards() const { return (int)shards.size(); }
+    
+    bool get(int key, int* value) {
+        Shard& shard = shard_of(key);
+        if (stripe_lock_shared_blocked(shard.lock)) {
+            shard.read_blocks.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.reads.fetch_add(1, std::memory_order_relaxed);
+        bool found = shard.table.find(key, value);
+        shard.lock.unlock_shared();
+        return found;
+    }
+    
+    void put(int key, int value) {
+        Shard& shard = shard_of(key);
+        if (stripe_lock_blocked(shard.lock)) {
+            shard.write_blocks.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.writes.fetch_add(1, std::memory_order_relaxed);
+        shard.table.insert_or_assign(key, value);
+        shard.lock.unlock();
+    }
+    
+    bool remove(int key) {
+        Shard& shard = shard_of(key);
+        if (stripe_lock_blocked(shard.lock)) {
+            shard.write_blocks.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.writes.fetch_add(1, std::memory_order_relaxed);
+        bool erased = shard.table.erase(key);
+        shard.lock.unlock();
+        return erased;
+    }
+    
+    std::size_t memory_bytes() const {
+        std::size_t bytes = 0;
+        for (const Shard& shard : shards) bytes += shard.table.memory_bytes();
+        return bytes;
+    }
+    
+    void get_stats(long* r, long* w, long* rb, long* wb) {
+        *r = 0;
+        *w = 0;
+        *rb = 0;
+        *wb = 0;
+        for (Shard& shard : shards) {
+            *r += shard.reads.load(std::memory_order_relaxed);
+            *w += shard.writes.load(std::memory_order_relaxed);
+            *rb += shard.read_blocks.load(std::memory_order_relaxed);
+            *wb += shard.write_blocks.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+// ============================================================================
+// HASHMAP REDIMENSIONABLE CON REHASH INCREMENTAL
+// ============================================================================
+
+/**
+ * HashMap que duplica su tabla según el factor de carga, sin pausas largas
+ *
+ * - STRIPES locks; la franja de una clave son los bits bajos de su hash.
+ *   Como las tablas son potencias de 2 >= STRIPES, el bucket de la clave en
+ *   la tabla vieja y en la nueva cae bajo el mismo lock: mover un bucket
+ *   solo requiere el lock de su franja
+ * - Cada franja cuenta sus claves; si una supera tamaño/STRIPES (carga 1)
+ *   se publica una tabla del doble (next) y empieza la migración
+ * - Migración cooperativa: toda escritura mueve primero el bucket viejo de
+ *   su clave y luego MIGRATE_STEP buckets más de su franja; cuando su franja
+ *   terminó, ayuda a otra. Un bucket movido queda marcado (moved()): las
+ *   lecturas buscan en la tabla vieja si no se movió y si no en la nueva
+ * - current/next solo cambian con los STRIPES locks tomados (al publicar y
+ *   al terminar), y se leen con el de la franja: quien los lee nunca ve una
+ *   tabla liberada. Tomar 64 locks no mueve datos; la copia va repartida
+ *
+ * Con incremental = false el escritor que dispara el crecimiento rehace la
+ * tabla entera con todos los locks tomados (el rehash clásico), para
+ * comparar la latencia de cola.
+ */
+template<typename StripeLock, typename NodeAlloc = HeapNodes>
+class ResizableHashMap {
+public:
+    static constexpr int STRIPES = 64;
+    static constexpr int MIGRATE_STEP = 8;    // Buckets extra que mueve cada escritura
+
+private:
+    struct Table {
+        std::size_t size;      // Potencia de 2 >= STRIPES
+        Node** buckets;
+        std::atomic<std::size_t> migrated{0};  // Buckets ya movidos a la siguiente
+        
+        // calloc: las páginas en cero se asignan al tocarlas, no al reservar
+        explicit Table(std::size_t n)
+            : size(n), buckets(static_cast<Node**>(std::calloc(n, sizeof(Node*)))) {
+            if (!buckets) abort();
+        }
+        ~Table() { std::free(buckets); }
+    };
+    
+    struct alignas(CACHE_LINE_SIZE) Stripe {
+        StripeLock lock;
+        long entries = 0;              // Claves de la franja (con el lock)
+        long writes = 0;
+        long write_blocks = 0;         // Escrituras que encontraron el lock ocupado
+        std::atomic<long> read_blocks{0};  // Atómico: se suma con el lock compartido
+        std::size_t migrate_cursor = 0;  // Siguiente bucket viejo propio a mover
+    };
+    
+    Stripe stripes[STRIPES];
+    NodeAlloc nodes;
+    const bool incremental;
+    
+    Table* current;
+    Table* next = nullptr;               // != nullptr mientras se migra
+    alignas(CACHE_LINE_SIZE) std::atomic<unsigned> help_cursor{0};
+    std::atomic<long> resize_count{0};
+    
+    // Marca de bucket ya migrado (nunca se desreferencia)
+    static Node* moved() {
+        static Node marker(0, 0);
+        return &marker;
+    }
+    
+    // Finalizador de MurmurHash3 (32 bits): los bits bajos eligen franja y bucket
+    static uint32_t hash(int key) {
+        uint32_t h = (uint32_t)key;
+        h ^= h >> 16;
+        h *= 0x85ebca6bU;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35U;
+        h ^= h >> 16;
+        return h;
+    }
+    
+    void lock_all() {
+        for (Stripe& stripe : stripes) stripe.lock.lock();  // Siempre en orden
+    }
+    
+    void unlock_all() {
+        for (Stripe& stripe : stripes) stripe.lock.unlock();
+    }
+    
+    // Mover un bucket viejo a next (con el lock de su franja)
+    void migrate_bucket(std::size_t old_idx) {
+        Node* current_node = current->buckets[old_idx];
+        if (current_node == moved()) return;
+        std::size_t mask = next->size - 1;
+        while (current_node) {
+            Node* following = current_node->next;
+            Node*& head = next->buckets[hash(current_node->key) & mask];
+            current_node->next = head;
+            head = current_node;
+            current_node = following;
+        }
+        current->buckets[old_idx] = moved();
+        current->migrated.fetch_add(1, std::memory_order_acq_rel);
+    }
+    
+    /**
+     * Avanzar la migración de la franja s
+     * @return: true si la franja ya no tiene buckets viejos pendientes
+     */
+    bool migrate_stripe(int s) {
+        Stripe& stripe = stripes[s];
+        std::size_t per_stripe = current->size / STRIPES;
+        for (int i = 0; i < MIGRATE_STEP && stripe.migrate_cursor < per_stripe; i++) {
+            migrate_bucket((std::size_t)s + stripe.migrate_cursor++ * STRIPES);
+        }
+        return stripe.migrate_cursor >= per_stripe;
+    }
+    
+    bool migration_complete() const {
+        return current->migrated.load(std::memory_order_acquire) == current->size;
+    }
+    
+    // Bucket donde debe quedar la clave (con el lock exclusivo de su franja)
+    Node** bucket_for_write(uint32_t h) {
+        if (!next) return &current->buckets[h & (current->size - 1)];
+        migrate_bucket(h & (current->size - 1));
+        return &next->buckets[h & (next->size - 1)];
+    }
+    
+    // Lo que una escritura decide con el lock de su franja y hace al soltarlo
+    struct AfterWrite {
+        Table* resizing_to = nullptr;   // Tabla en migración (si la hay)
+        bool finish = false;            // Se movió el último bucket
+        bool help = false;              // La franja propia ya terminó
+        Table* grow_from = nullptr;     // Tabla a duplicar
+        std::size_t grow_size = 0;
+    };
+    
+    AfterWrite after_write_locked(int s) {
+        AfterWrite after;
+        if (next) {
+            after.resizing_to = next;
+            after.help = migrate_stripe(s);
+            after.finish = migration_complete();
+        } else if (stripes[s].entries > (long)(current->size / STRIPES)) {
+            after.grow_from = current;
+            after.grow_size = current->size;
+        }
+        return after;
+    }
+    
+    void after_write(const AfterWrite& after) {
+        if (after.finish) {
+            finish_resize(after.resizing_to);
+        } else if (after.help) {
+            help_migrate();
+        }
+        if (after.grow_from) begin_resize(after.grow_from, after.grow_size);
+    }
+    
+    /**
+     * Publicar una tabla del doble (o, sin modo incremental, rehacer todo ya)
+     * seen/seen_size: la tabla que vio el escritor (puede haber cambiado)
+     */
+    void begin_resize(Table* seen, std::size_t seen_size) {
+        Table* bigger = new Table(seen_size * 2);  // Fuera de los locks
+        lock_all();
+        if (current != seen || current->size != seen_size || next) {
+            unlock_all();     // Otro hilo ya lo hizo
+            delete bigger;
+            return;
+        }
+        resize_count.fetch_add(1, std::memory_order_relaxed);
+        next = bigger;
+        for (Stripe& stripe : stripes) stripe.migrate_cursor = 0;
+        
+        if (incremental) {
+            unlock_all();
+            return;
+        }
+        for (std::size_t i = 0; i < current->size; i++) migrate_bucket(i);
+        Table* old = current;
+        current = next;
+        next = nullptr;
+        unlock_all();
+        delete old;
+    }
+    
+    void finish_resize(Table* resizing_to) {
+        lock_all();
+        if (next != resizing_to || !migration_complete()) {
+            unlock_all();     // Otro hilo ya terminó
+            return;
+        }
+        Table* old = current;
+        current = next;
+        next = nullptr;
+        unlock_all();
+        delete old;           // Nadie la ve: current/next se leen con un lock
+    }
+    
+    /**
+     * Mover buckets de otra franja (round-robin) cuando la propia terminó
+     */
+    void help_migrate() {
+        int s = (int)(help_cursor.fetch_add(1, std::memory_order_relaxed) % STRIPES);
+        Stripe& stripe = stripes[s];
+        stripe.lock.lock();
+        Table* resizing_to = next;
+        bool finish = false;
+        if (next) {
+            migrate_stripe(s);
+            finish = migration_complete();
+        }
+        stripe.lock.unlock();
+        if (finish) finish_resize(resizing_to);
+    }
+
+public:
+    explicit ResizableHashMap(bool incremental_rehash = true,
+                              std::size_t initial_buckets = NUM_BUCKETS)
+        : incremental(incremental_rehash),
+          current(new Table(round_up_pow2(std::max(initial_buckets, (std::size_t)STRIPES)))) {}
+    
+    ~ResizableHashMap() {
+        for (Table* table : {current, next}) {
+            if (!table) continue;
+            for (std::size_t i = 0; i < table->size; i++) {
+                Node* node = table->buckets[i];
+                if (node == moved()) continue;
+                while (node) {
+                    Node* following = node->next;
+                    nodes.destroy(node);
+                    node = following;
+                }
+            }
+            delete table;
+        }
+    }
+    
+    ResizableHashMap(const ResizableHashMap&) = delete;
+    ResizableHashMap& operator=(const ResizableHashMap&) = delete;
+    
+    bool get(int key, int* value) {
+        uint32_t h = hash(key);
+        Stripe& stripe = stripes[h & (STRIPES - 1)];
+        if (stripe_lock_shared_blocked(stripe.lock)) {
+            stripe.read_blocks.fetch_add(1, std::memory_order_relaxed);
+        }
+        Node* node = current->buckets[h & (current->size - 1)];
+        if (node == moved()) node = next->buckets[h & (next->size - 1)];
+        for (; node; node = node->next) {
+            if (node->key == key) {
+                *value = node->value;
+                stripe.lock.unlock_shared();
+                return true;
+            }
+        }
+        stripe.lock.unlock_shared();
+        return false;
+    }
+    
+    void put(int key, int value) {
+        nodes.prepare();
+        uint32_t h = hash(key);
+        int s = (int)(h & (STRIPES - 1));
+        Stripe& stripe = stripes[s];
+        if (stripe_lock_blocked(stripe.lock)) stripe.write_blocks++;
+        stripe.writes++;
+        
+        Node** bucket = bucket_for_write(h);
+        Node* node = *bucket;
+        while (node && node->key != key) node = node->next;
+        if (node) {
+            node->value = value;
+        } else {
+            Node* new_node = nodes.create(key, value);
+            new_node->next = *bucket;
+            *bucket = new_node;
+            stripe.entries++;
+        }
+        
+        AfterWrite after = after_write_locked(s);
+        stripe.lock.unlock();
+        after_write(after);
+    }
+    
+    bool remove(int key) {
+        uint32_t h = hash(key);
+        int s = (int)(h & (STRIPES - 1));
+        Stripe& stripe = stripes[s];
+        if (stripe_lock_blocked(stripe.lock)) stripe.write_blocks++;
+        stripe.writes++;
+        
+        Node** link = bucket_for_write(h);
+        while (*link && (*link)->key != key) link = &(*link)->next;
+        Node* removed = *link;
+        if (removed) {
+            *link = removed->next;
+            stripe.entries--;
+        }
+        
+        AfterWrite after = after_write_locked(s);
+        stripe.lock.unlock();
+        if (removed) nodes.destroy(removed);
+        after_write(after);
+        return removed != nullptr;
+    }
+    
+    // Con los hilos detenidos
+    std::size_t bucket_count() const { return next ? next->size : current->size; }
+    long resizes() const { return resize_count.load(std::memory_order_relaxed); }
+    long size() const {
+        long total = 0;
+        for (const Stripe& stripe : stripes) total += stripe.entries;
+        return total;
+    }
+    
+    void get_stats(long* r, long* w, long* rb, long* wb) {
+        *r = 0;  // Las operaciones se cuentan por hilo
+        *w = 0;
+        *rb = 0;
+        *wb = 0;
+        for (const Stripe& stripe : stripes) {
+            *w += stripe.writes;
+            *rb += stripe.read_blocks.load(std::memory_order_relaxed);
+            *wb += stripe.write_blocks;
+        }
+    }
+};
+
+// ============================================================================
+// HILOS WORKER PARA BENCHMARKS
+// ============================================================================
+
+struct WorkerArgs {
+    void* hashmap;           // Puntero al hashmap del tipo que instancia worker_thread
+    int thread_id;
+    long operations;
+    const WorkloadOp* ops;   // Operaciones pre-generadas (clave, tipo, valor)
+    long reads_done;         // Operaciones hechas por este hilo (al terminar)
+    long writes_done;
+    int sample_every;        // Medir 1 de cada N operaciones (0 = ninguna)
+    LatencyHistogram* get_latency;    // Ciclos por get() muestreado (de este hilo)
+    LatencyHistogram* write_latency;  // Ciclos por put()/remove() muestreado
+};
+
+/**
+ * Worker thread que ejecuta mezcla de operaciones de lectura/escritura
+ * Se instancia por tipo de hashmap (la llamada a get/put no es virtual)
+ * Las operaciones ya vienen generadas: el ciclo medido no usa el RNG
+ *
+ * Cada sample_every operaciones una se mide con dos lecturas del TSC y va
+ * al histograma del hilo: sin llamadas al sistema ni escrituras compartidas
+ */
+template<typename HashMap>
+void* worker_thread(void* arg) {
+    WorkerArgs* args = static_cast<WorkerArgs*>(arg);
+    HashMap* map = static_cast<HashMap*>(args->hashmap);
+    long reads = 0;
+    long writes = 0;
+    int countdown = args->sample_every;
+    
+    for (long i = 0; i < args->operations; i++) {
+        const WorkloadOp& op = args->ops[i];
+        bool sample = countdown > 0 && --countdown == 0;
+        uint64_t start = 0;
+        if (sample) {
+            countdown = args->sample_every;
+            start = read_cycles();
+        }
+        
+        if (op.kind == OP_GET) {
+            // Operación de lectura
+            int value;
+            map->get(op.key, &value);
+            reads++;
+            if (sample) args->get_latency->record(read_cycles() - start);
+        } else {
+            // Operación de escritura: eliminación o inserción/actualización
+            if (op.kind == OP_REMOVE) {
+                map->remove(op.key);
+            } else {
+                map->put(op.key, op.value);
+            }
+            writes++;
+            if (sample) args->write_latency->record(read_cycles() - start);
+        }
+    }
+    
+    // Contadores locales: se publican una vez (WorkerArgs vecinos comparten línea)
+    args->reads_done = reads;
+    args->writes_done = writes;
+    return nullptr;
+}
+
+// ============================================================================
+// FUNCIONES DE BENCHMARK
+// ============================================================================
+
+/**
+ * Estadísticas propias de cada variante, después del reporte común
+ * (la sobrecarga no plantilla gana sobre la genérica). reads/writes son las
+ * operaciones contadas por los hilos, exactas en todas las variantes
+ */
+template<typename HashMap>
+void print_map_details(HashMap*, long, long) {}
+
+void print_map_details(SeqlockHashMap* map, long, long) {
+    printf("Reintentos de lectura (seqlock): %ld\n",
+           map->read_retries.load(std::memory_order_relaxed));
+    EbrStats stats = map->reclamation_stats();
+    printf("Reclamación EBR: %ld retirados, %ld liberados, %ld pendientes (pico %ld)\n",
+           stats.retired, stats.reclaimed, stats.pending, stats.peak_pending);
+}
+
+template<typename NodeAlloc>
+void print_write_hold(const char* lock_name, long hold_ns, long samples) {
+    printf("Sección crítica de escritura (%s, nodos %s): %.1f ns promedio (%ld muestras)\n",
+           lock_name, NodeAlloc::NAME, samples ? (double)hold_ns / samples : 0.0, samples);
+}
+
+/**
+ * Contención real: operaciones cuyo trylock falló (el lock estaba tomado)
+ */
+void print_lock_blocks(long reads, long writes, long read_blocks, long write_blocks) {
+    printf("Bloqueos: lecturas %ld (%.2f%%), escrituras %ld (%.2f%%)\n",
+           read_blocks, reads ? 100.0 * read_blocks / reads : 0.0,
+           write_blocks, writes ? 100.0 * write_blocks / writes : 0.0);
+}
+
+/**
+ * Bloqueos que el mapa suma en get_stats() (por hilo, franja o shard)
+ */
+template<typename HashMap>
+void print_map_blocks(HashMap* map, long reads, long writes) {
+    long map_reads, map_writes, read_blocks, write_blocks;
+    map->get_stats(&map_reads, &map_writes, &read_blocks, &write_blocks);
+    print_lock_blocks(reads, writes, read_blocks, write_blocks);
+}
+
+template<typename NodeAlloc>
+void print_map_details(MutexHashMap<NodeAlloc>* map, long reads, long writes) {
+    print_lock_blocks(reads, writes, map->read_blocks, map->write_blocks);
+    print_write_hold<NodeAlloc>("mutex", map->write_hold_ns, map->write_hold_samples);
+}
+
+template<typename NodeAlloc, typename RWLock>
+void print_map_details(RWLockHashMap<NodeAlloc, RWLock>* map, long reads, long writes) {
+    printf("Lock: %s\n", RWLock::NAME);
+    print_lock_blocks(reads, writes, map->read_blocks.load(), map->write_blocks);
+    printf("Espera de escritores: %.1f ns promedio por escritura, máximo %.1f us\n",
+           writes ? (double)map->write_wait_ns / writes : 0.0,
+           map->write_wait_max_ns / 1000.0);
+    print_write_hold<NodeAlloc>("wrlock", map->write_hold_ns, map->write_hold_samples);
+}
+
+/**
+ * Variantes con lock por franja o shard: bloqueos sumados de todas
+ */
+template<typename StripeLock>
+void print_map_details(StripedHashMap<StripeLock>* map, long reads, long writes) {
+    print_map_blocks(map, reads, writes);
+}
+
+template<typename StripeLock>
+void print_map_details(FlatHashMap<StripeLock>* map, long reads, long writes) {
+    print_map_blocks(map, reads, writes);
+}
+
+template<typename StripeLock, typename NodeAlloc>
+void print_map_details(ResizableHashMap<StripeLock, NodeAlloc>* map, long reads, long writes) {
+    print_map_blocks(map, reads, writes);
+}
+
+void print_map_details(RcuHashMap* map, long, long) {
+    EbrStats stats = map->reclamation_stats();
+    long live = map->live_nodes.load(std::memory_order_relaxed);
+    std::size_t live_bytes = (std::size_t)live * sizeof(RcuNode);
+    printf("Reclamación EBR: %ld retirados, %ld liberados, %ld pendientes, "
+           "%ld avances de época\n",
+           stats.retired, stats.reclaimed, stats.pending, stats.epoch_advances);
+    stats.latency.print_summary("Latencia de reclamación (retire -> free)");
+    printf("Memoria: %ld nodos vivos (%zu B) + pico de %ld retirados (%zu B) = %.1f%% extra\n",
+           live, live_bytes, stats.peak_pending, stats.peak_pending_bytes,
+           live_bytes > 0 ? 100.0 * stats.peak_pending_bytes / live_bytes : 0.0);
+}
+
+/**
+ * Percentiles de un histograma en ciclos, convertidos a ns
+ */
+void print_op_latency(const char* label, const LatencyHistogram& cycles) {
+    if (cycles.count() == 0) return;
+    printf("Latencia %-9s n=%-8llu p50=%llu ns p99=%llu ns p99.9=%llu ns max=%llu ns\n",
+           label, (unsigned long long)cycles.count(),
+           (unsigned long long)cycles_to_ns(cycles.percentile(50.0)),
+           (unsigned long long)cycles_to_ns(cycles.percentile(99.0)),
+           (unsigned long long)cycles_to_ns(cycles.percentile(99.9)),
+           (unsigned long long)cycles_to_ns(cycles.max()));
+}
+
+/**
+ * Ejecutar un flujo de operaciones por hilo sobre el mapa y reportar
+ * (los flujos vienen de generate() o de una traza mapeada)
+ */
+template<typename HashMap>
+double benchmark_streams(HashMap* map, const std::vector<OpStream>& streams) {
+    int num_threads = (int)streams.size();
+    std::vector<PoolTask> tasks(num_threads);
+    std::vector<WorkerArgs> args(num_threads);
+    std::vector<LatencyHistogram> get_latency(num_threads);    // Uno por hilo, en ciclos
+    std::vector<LatencyHistogram> write_latency(num_threads);
+    cycles_per_ns();  // Calibrar antes de medir
+    
+    // Preparar tareas para los workers del pool
+    for (int i = 0; i < num_threads; i++) {
+        args[i] = {
+            .hashmap = map,
+            .thread_id = i,
+            .operations = streams[i].count,
+            .ops = streams[i].ops,
+            .reads_done = 0,
+            .writes_done = 0,
+            .sample_every = g_sample_every,
+            .get_latency = &get_latency[i],
+            .write_latency = &write_latency[i]
+        };
+        
+        tasks[i] = {worker_thread<HashMap>, &args[i], 0};
+    }
+    
+    // Liberar juntos y esperar terminación (tiempo desde la barrera de inicio)
+    double duration = g_pool.run(tasks);
+    
+    // Obtener estadísticas: operaciones contadas por cada hilo (exactas para
+    // cualquier variante, incluso las que no cuentan lecturas en el mapa)
+    long map_reads, map_writes, read_blocks, write_blocks;
+    map->get_stats(&map_reads, &map_writes, &read_blocks, &write_blocks);
+    long reads = 0;
+    long writes = 0;
+    for (const WorkerArgs& a : args) {
+        reads += a.reads_done;
+        writes += a.writes_done;
+    }
+    
+    long total_ops = reads + writes;
+    double throughput = total_ops / duration;
+    
+    printf("Tiempo: %.4f seg\n", duration);
+    printf("Operaciones totales: %ld (R: %ld, W: %ld)\n", total_ops, reads, writes);
+    printf("Throughput: %.2f ops/seg\n", throughput);
+    printf("Proporción real R/W: %.1f%%/%.1f%%\n", 
+           100.0 * reads / total_ops, 100.0 * writes / total_ops);
+    
+    LatencyHistogram get_total;
+    LatencyHistogram write_total;
+    for (int i = 0; i < num_threads; i++) {
+        get_total.merge(get_latency[i]);
+        write_total.merge(write_latency[i]);
+    }
+    print_op_latency("get():", get_total);
+    print_op_latency("put():", write_total);
+    print_map_details(map, reads, writes);
+    
+    return throughput;
+}
+
+template<typename HashMap>
+double benchmark_hashmap(const char* name, HashMap* map,
+                        int num_threads, long ops_per_thread, int read_pct,
+                        int remove_pct = 0) {
+    
+    printf("\n--- Benchmarking %s (R/W: %d/%d%%) ---\n", 
+           name, read_pct, 100 - read_pct);
+    if (remove_pct > 0) {
+        printf("Escrituras: %d%% remove(), %d%% put()\n", remove_pct, 100 - remove_pct);
+    }
+    
+    // Generar las operaciones de cada hilo antes de medir (semillas
+    // diferentes pero reproducibles)
+    std::vector<std::vector<WorkloadOp>> workloads(num_threads);
+    std::vector<OpStream> streams(num_threads);
+    for (int i = 0; i < num_threads; i++) {
+        workloads[i] = g_key_dist.generate(ops_per_thread, read_pct, remove_pct,
+                                           i, num_threads, 42 + i);
+        streams[i] = {workloads[i].data(), ops_per_thread};
+    }
+    
+    return benchmark_streams(map, streams);
+}
+
+/**
+ * Reproducir una traza sobre un mapa recién creado (vacío: la traza trae
+ * su propia fase de carga si la necesita); el mapa se libera al terminar
+ */
+template<typename HashMap>
+double replay_trace(const char* name, HashMap* map, const OpTrace& trace) {
+    printf("\n--- Reproduciendo traza en %s (%d hilos, %ld ops) ---\n",
+           name, trace.num_threads(), trace.total_ops());
+    double throughput = benchmark_streams(map, trace.thread_streams());
+    delete map;
+    return throughput;
+}
+
+void run_trace_replay(const OpTrace& trace, int num_stripes, bool striped_mutex,
+                      bool striped_rwlock, bool striped_spin) {
+    std::vector<std::pair<const char*, double>> results;
+    auto add = [&results](const char* column, double throughput) {
+        results.emplace_back(column, throughput);
+    };
+    
+    add("Mutex", replay_trace("Mutex HashMap", new MutexHashMap<>(), trace));
+    add("RWLock", replay_trace("RWLock HashMap", new RWLockHashMap<>(), trace));
+    add("BRLock", replay_trace("BRLock HashMap", new BrlockHashMap(), trace));
+    if (striped_mutex) {
+        add("Striped mutex", replay_trace("Striped HashMap (mutex)",
+                                          new StripedHashMap<StripeMutex>(num_stripes), trace));
+    }
+    if (striped_rwlock) {
+        add("Striped rwlock", replay_trace("Striped HashMap (rwlock)",
+                                           new StripedHashMap<StripeRWLock>(num_stripes), trace));
+    }
+    if (striped_spin) {
+        add("Striped spin", replay_trace("Striped HashMap (spin)",
+                                         new StripedHashMap<StripeSpinLock>(num_stripes), trace));
+    }
+    add("Seqlock", replay_trace("Seqlock HashMap", new SeqlockHashMap(), trace));
+    add("RCU (EBR)", replay_trace("RCU HashMap (EBR)", new RcuHashMap(), trace));
+    add("Flat mutex", replay_trace("Flat HashMap (mutex)", new FlatHashMap<StripeMutex>(1), trace));
+    add("Flat rwlock", replay_trace("Flat HashMap (rwlock)", new FlatHashMap<StripeRWLock>(1), trace));
+    add("Resizable", replay_trace("Resizable HashMap (spin)",
+                                  new ResizableHashMap<StripeSpinLock>(), trace));
+    
+    printf("\n=== RESUMEN DE LA TRAZA (Mops/seg) ===\n");
+    for (const auto& result : results) {
+        printf("%-16s %10.3f\n", result.first, result.second / 1e6);
+    }
+}
+
+/**
+ * Poblar el hashmap con datos iniciales
+ */
+template<typename HashMap>
+void populate_hashmap(HashMap* map, int num_entries) {
+    std::mt19937 rng(42);  // Semilla fija para reproducibilidad
+    std::uniform_int_distribution<int> key_dist(0, KEY_RANGE - 1);
+    std::uniform_int_distribution<int> val_dist(1, 1000);
+    
+    for (int i = 0; i < num_entries; i++) {
+        int key = key_dist(rng);
+        int value = val_dist(rng);
+        map->put(key, value);
+    }
+}
+
+/**
+ * Correr StripedHashMap<StripeLock> con la misma mezcla que los demás mapas
+ */
+template<typename StripeLock>
+double benchmark_striped(int num_stripes, int num_threads, long ops_per_thread, int read_pct) {
+    StripedHashMap<StripeLock> map(num_stripes);
+    populate_hashmap(&map, INITIAL_ENTRIES);
+    char name[64];
+    snprintf(name, sizeof(name), "Striped HashMap (%d x %s)", map.num_stripes(), StripeLock::NAME);
+    return benchmark_hashmap(name, &map, num_threads, ops_per_thread, read_pct);
+}
+
+/**
+ * Crear un mapa nuevo, poblarlo y medirlo (cada corrida parte del mismo estado)
+ * El mapa va en el heap: algunas variantes ocupan decenas de KB
+ */
+template<typename HashMap>
+double benchmark_fresh(const char* name, int num_threads, long ops_per_thread, int read_pct,
+                       int remove_pct = 0) {
+    HashMap* map = new HashMap();
+    populate_hashmap(map, INITIAL_ENTRIES);
+    double throughput = benchmark_hashmap(name, map, num_threads, ops_per_thread, read_pct,
+                                          remove_pct);
+    delete map;
+    return throughput;
+}
+
+/**
+ * Correr FlatHashMap<StripeLock> (1 shard = lock global, N = striping)
+ */
+template<typename StripeLock>
+double benchmark_flat(int num_shards, int num_threads, long ops_per_thread, int read_pct) {
+    FlatHashMap<StripeLock>* map = new FlatHashMap<StripeLock>(num_shards);
+    populate_hashmap(map, INITIAL_ENTRIES);
+    char name[64];
+    snprintf(name, sizeof(name), "Flat HashMap (%d x %s)", map->num_shards(), StripeLock::NAME);
+    double throughput = benchmark_hashmap(name, map, num_threads, ops_per_thread, read_pct);
+    delete map;
+    return throughput;
+}
+
+/**
+ * Costo de una búsqueda en un solo hilo: ns/lookup y fallos de LLC/lookup
+ * sobre el mapa lleno (KEY_RANGE claves), con las claves a buscar ya
+ * generadas para que el RNG no entre en la medición
+ */
+template<typename HashMap>
+void measure_lookups(const char* name, const std::vector<int>& lookup_keys) {
+    HashMap* map = new HashMap();
+    std::vector<int> insert_order(KEY_RANGE);
+    for (int i = 0; i < KEY_RANGE; i++) insert_order[i] = i;
+    std::shuffle(insert_order.begin(), insert_order.end(), std::mt19937(7));
+    for (int key : insert_order) map->put(key, key + 1);
+    
+    // Pasada de calentamiento (mismas condiciones para todos los mapas)
+    long checksum = 0;
+    int value = 0;
+    for (int key : lookup_keys) {
+        if (map->get(key, &value)) checksum += value;
+    }
+    
+    PerfCounter llc;
+    bool has_llc = llc.open_llc_misses();
+    double start = now_s();
+    llc.start();
+    for (int key : lookup_keys) {
+        if (map->get(key, &value)) checksum += value;
+    }
+    uint64_t misses = llc.stop();
+    double elapsed = now_s() - start;
+    
+    double n = (double)lookup_keys.size();
+    if (has_llc) {
+        printf("%-28s %10.1f %16.4f   (checksum %ld)\n", name, elapsed * 1e9 / n,
+               misses / n, checksum);
+    } else {
+        printf("%-28s %10.1f %16s   (checksum %ld)\n", name, elapsed * 1e9 / n, "n/d", checksum);
+    }
+    delete map;
+}
+
+// Envoltorios de 1 y num_stripes shards con constructor por defecto para measure_lookups
+template<typename StripeLock>
+struct FlatSingle : FlatHashMap<StripeLock> { FlatSingle() : FlatHashMap<StripeLock>(1) {} };
+template<typename StripeLock>
+struct FlatStriped : FlatHashMap<StripeLock> {
+    FlatStriped() : FlatHashMap<StripeLock>(DEFAULT_STRIPES) {}
+};
+template<typename StripeLock>
+struct StripedDefault : StripedHashMap<StripeLock> {
+    StripedDefault() : StripedHashMap<StripeLock>(DEFAULT_STRIPES) {}
+};
+
+void run_lookup_latency(long num_lookups) {
+    std::vector<int> lookup_keys(num_lookups);
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> key_dist(0, KEY_RANGE - 1);
+    for (int& key : lookup_keys) key = key_dist(rng);
+    
+    printf("\n=== BÚSQUEDA EN UN HILO: ENCADENADO vs PLANO (%d claves, %ld búsquedas) ===\n",
+           KEY_RANGE, num_lookups);
+    PerfCounter probe;
+    if (probe.open_llc_misses()) {
+        printf("Contador: %s (perf_event_open, solo modo usuario)\n", probe.name());
+    } else {
+        printf("⚠️  perf_event_open no disponible (%s): fallos de LLC = n/d\n", probe.error());
+    }
+    printf("%-28s %10s %16s\n", "Mapa", "ns/lookup", "LLC miss/lookup");
+    measure_lookups<MutexHashMap<>>("Mutex (encadenado)", lookup_keys);
+    measure_lookups<FlatSingle<StripeMutex>>("Flat (1 x mutex)", lookup_keys);
+    measure_lookups<RWLockHashMap<>>("RWLock (encadenado)", lookup_keys);
+    measure_lookups<FlatSingle<StripeRWLock>>("Flat (1 x rwlock)", lookup_keys);
+    measure_lookups<StripedDefault<StripeSpinLock>>("Striped spin (encadenado)", lookup_keys);
+    measure_lookups<FlatStriped<StripeSpinLock>>("Flat striped spin", lookup_keys);
+    
+    FlatSingle<StripeMutex> single;
+    FlatStriped<StripeSpinLock> striped;
+    printf("Memoria plana: %zu B (1 shard), %zu B (%d shards) para hasta %d claves; "
+           "encadenado: %zu B de buckets + %zu B por nodo\n",
+           single.memory_bytes(), striped.memory_bytes(), striped.num_shards(), KEY_RANGE,
+           sizeof(Node*) * NUM_BUCKETS, sizeof(Node));
+}
+
+/**
+ * Nodos con new/delete vs pool por hilo en los mapas de lock global, con
+ * escrituras mitad put() y mitad remove() para que las inserciones asignen
+ * nodos de verdad (sin remove(), tras llenarse el mapa put() solo actualiza)
+ */
+template<typename HashMap>
+void measure_allocator(const char* name, int num_threads, long ops_per_thread,
+                       int read_pct, double* throughput, double* hold_ns) {
+    HashMap* map = new HashMap();
+    populate_hashmap(map, INITIAL_ENTRIES);
+    *throughput = benchmark_hashmap(name, map, num_threads, ops_per_thread, read_pct, 50);
+    *hold_ns = map->write_hold_samples ? (double)map->write_hold_ns / map->write_hold_samples : 0.0;
+    delete map;
+}
+
+void run_allocator_comparison(int num_threads, long ops_per_thread) {
+    struct Row { int read_pct; const char* lock; double heap_tput, heap_hold, pool_tput, pool_hold; };
+    std::vector<Row> rows;
+    for (int read_pct : {30, 10}) {
+        Row mutex_row = {read_pct, "Mutex", 0, 0, 0, 0};
+        measure_allocator<MutexHashMap<HeapNodes>>("Mutex HashMap (new/delete)", num_threads,
+            ops_per_thread, read_pct, &mutex_row.heap_tput, &mutex_row.heap_hold);
+        measure_allocator<MutexHashMap<PooledNodes>>("Mutex HashMap (pool)", num_threads,
+            ops_per_thread, read_pct, &mutex_row.pool_tput, &mutex_row.pool_hold);
+        rows.push_back(mutex_row);
+        
+        Row rwlock_row = {read_pct, "RWLock", 0, 0, 0, 0};
+        measure_allocator<RWLockHashMap<HeapNodes>>("RWLock HashMap (new/delete)", num_threads,
+            ops_per_thread, read_pct, &rwlock_row.heap_tput, &rwlock_row.heap_hold);
+        measure_allocator<RWLockHashMap<PooledNodes>>("RWLock HashMap (pool)", num_threads,
+            ops_per_thread, read_pct, &rwlock_row.pool_tput, &rwlock_row.pool_hold);
+        rows.push_back(rwlock_row);
+    }
+    
+    printf("\n=== NODOS: NEW/DELETE vs POOL POR HILO (escrituras 50%% put / 50%% remove) ===\n");
+    printf("%-6s %-8s %14s %14s %12s %12s %9s\n", "R/W", "Lock", "W Mops (heap)",
+           "W Mops (pool)", "SC heap ns", "SC pool ns", "SC menos");
+    for (const Row& row : rows) {
+        double write_share = (100 - row.read_pct) / 100.0;
+        printf("%2d/%-3d %-8s %14.3f %14.3f %12.1f %12.1f %8.0f%%\n",
+               row.read_pct, 100 - row.read_pct, row.lock,
+               row.heap_tput * write_share / 1e6, row.pool_tput * write_share / 1e6,
+               row.heap_hold, row.pool_hold,
+               row.heap_hold > 0 ? 100.0 * (1.0 - row.pool_hold / row.heap_hold) : 0.0);
+    }
+    printf("SC = sección crítica de escritura (muestreo 1/%d); W Mops = escrituras/seg\n",
+           HOLD_SAMPLE_EVERY);
+}
+
+/**
+ * Mismo RWLockHashMap con cada lock de rw_locks.hpp: throughput y cuánto
+ * esperan los escritores por el lock (el hambre de escritores se ve en la
+ * espera máxima y en la cola de put())
+ */
+struct RWLockRow {
+    const char* lock;
+    double throughput;
+    double blocked_pct;     // % de escrituras que encontraron el lock tomado
+    double wait_per_write;  // ns de espera promedio por escritura
+    double wait_max_us;
+};
+
+template<typename RWLock>
+RWLockRow measure_rwlock(int num_threads, long ops_per_thread, int read_pct) {
+    typedef RWLockHashMap<HeapNodes, RWLock> Map;
+    Map* map = new Map();
+    populate_hashmap(map, INITIAL_ENTRIES);
+    std::string name = std::string("RWLock HashMap (") + RWLock::NAME + ")";
+    RWLockRow row;
+    row.lock = RWLock::NAME;
+    row.throughput = benchmark_hashmap(name.c_str(), map, num_threads, ops_per_thread, read_pct);
+    row.blocked_pct = map->writes ? 100.0 * map->write_blocks / map->writes : 0.0;
+    row.wait_per_write = map->writes ? (double)map->write_wait_ns / map->writes : 0.0;
+    row.wait_max_us = map->write_wait_max_ns / 1000.0;
+    delete map;
+    return row;
+}
+
+void run_rwlock_comparison(int num_threads, long ops_per_thread, int read_pct) {
+    std::vector<RWLockRow> rows;
+    rows.push_back(measure_rwlock<PthreadRWLock>(num_threads, ops_per_thread, read_pct));
+    rows.push_back(measure_rwlock<PthreadWriterPrefRWLock>(num_threads, ops_per_thread, read_pct));
+    rows.push_back(measure_rwlock<PhaseFairRWLock>(num_threads, ops_per_thread, read_pct));
+    rows.push_back(measure_rwlock<BigReaderRWLock>(num_threads, ops_per_thread, read_pct));
+    
+    printf("\n=== LOCKS LECTOR/ESCRITOR (RWLockHashMap, R/W %d/%d, %d hilos) ===\n",
+           read_pct, 100 - read_pct, num_threads);
+    printf("%-30s %10s %12s %16s %14s\n", "Lock", "Mops/seg", "W bloq.",
+           "Espera/W (ns)", "Espera máx us");
+    for (const RWLockRow& row : rows) {
+        printf("%-30s %10.3f %11.2f%% %16.1f %14.1f\n", row.lock, row.throughput / 1e6,
+               row.blocked_pct, row.wait_per_write, row.wait_max_us);
+    }
+    printf("W bloq. = escrituras cuyo try_lock falló; la espera se mide solo en esas\n");
+    if (num_threads > (int)std::thread::hardware_concurrency()) {
+        printf("⚠️  Más hilos que CPUs: phase-fair y big-reader esperan activamente, y un "
+               "lector registrado pero sin CPU retiene a los escritores\n");
+    }
+}
+
+/**
+ * Escenario de crecimiento: cada hilo inserta su parte de 0..total_keys-1
+ * (claves nuevas, el mapa arranca con NUM_BUCKETS buckets y se duplica unas
+ * log2(total_keys / NUM_BUCKETS) veces) y después de cada put() lee una
+ * clave propia ya insertada. Se registra la latencia de cada operación
+ */
+typedef ResizableHashMap<StripeSpinLock, PooledNodes> GrowthMap;
+
+struct GrowthArgs {
+    GrowthMap* map;
+    int thread_id;
+    int num_threads;
+    long total_keys;
+    LatencyHistogram put_latency;
+    LatencyHistogram get_latency;
+};
+
+void* growth_worker(void* arg) {
+    GrowthArgs* args = static_cast<GrowthArgs*>(arg);
+    std::mt19937 rng(1234 + args->thread_id);
+    long inserted = 0;
+    int value;
+    for (long key = args->thread_id; key < args->total_keys; key += args->num_threads) {
+        uint64_t t0 = now_ns();
+        args->map->put((int)key, (int)(key & 0xffff));
+        uint64_t t1 = now_ns();
+        inserted++;
+        long probe = args->thread_id + (long)(rng() % inserted) * args->num_threads;
+        args->map->get((int)probe, &value);
+        uint64_t t2 = now_ns();
+        args->put_latency.record(t1 - t0);
+        args->get_latency.record(t2 - t1);
+    }
+    return nullptr;
+}
+
+void run_growth_scenario(int num_threads, long total_keys) {
+    printf("\n=== CRECIMIENTO: %ld CLAVES NUEVAS, %d HILOS (tabla inicial %d buckets) ===\n",
+           total_keys, num_threads, NUM_BUCKETS);
+    
+    uint64_t worst_put[2] = {0, 0};
+    uint64_t p999_put[2] = {0, 0};
+    for (int mode = 0; mode < 2; mode++) {
+        bool incremental = (mode == 0);
+        GrowthMap* map = new GrowthMap(incremental);
+        std::vector<GrowthArgs> args(num_threads);
+        std::vector<PoolTask> tasks(num_threads);
+        for (int i = 0; i < num_threads; i++) {
+            args[i].map = map;
+            args[i].thread_id = i;
+            args[i].num_threads = num_threads;
+            args[i].total_keys = total_keys;
+            tasks[i] = {growth_worker, &args[i], 0};
+        }
+        
+        double duration = g_pool.run(tasks);
+        
+        LatencyHistogram put_latency;
+        LatencyHistogram get_latency;
+        for (const GrowthArgs& a : args) {
+            put_latency.merge(a.put_latency);
+            get_latency.merge(a.get_latency);
+        }
+        long entries = map->size();
+        printf("\n--- Rehash %s ---\n", incremental ? "incremental (cooperativo)" : "completo (stop-the-world)");
+        printf("Tiempo: %.3f seg, %.2f M put+get/seg\n", duration, total_keys / duration / 1e6);
+        printf("Duplicaciones: %ld, buckets finales: %zu, claves: %ld %s\n", map->resizes(),
+               map->bucket_count(), entries, entries == total_keys ? "✅" : "❌");
+        put_latency.print_summary("put()");
+        get_latency.print_summary("get()");
+        worst_put[mode] = put_latency.max();
+        p999_put[mode] = put_latency.percentile(99.9);
+        delete map;
+    }
+    
+    printf("\nCola de put(): p99.9 %llu ns vs %llu ns, máximo %llu ns vs %llu ns "
+           "(incremental vs completo)\n",
+           (unsigned long long)p999_put[0], (unsigned long long)p999_put[1],
+           (unsigned long long)worst_put[0], (unsigned long long)worst_put[1]);
+}
+
+/**
+ * Escalamiento de lecturas: mismo trabajo por hilo con 1, 2, 4, ... hilos
+ * hasta max_threads. Eficiencia = throughput / (hilos * throughput con 1 hilo);
+ * 100% es escalamiento lineal
+ */
+void run_read_scaling(int max_threads, long ops_per_thread, int read_pct) {
+    std::vector<int> thread_counts;
+    for (int t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+    
+    struct Row { int threads; double rwlock; double brlock; double striped; double seqlock; double rcu; };
+    std::vector<Row> rows;
+    for (int threads : thread_counts) {
+        Row row;
+        row.threads = threads;
+        row.rwlock = benchmark_fresh<RWLockHashMap<>>("RWLock HashMap", threads,
+                                                    ops_per_thread, read_pct);
+        row.brlock = benchmark_fresh<BrlockHashMap>("BRLock HashMap", threads,
+                                                    ops_per_thread, read_pct);
+        row.striped = benchmark_striped<StripeRWLock>(DEFAULT_STRIPES, threads,
+                                                      ops_per_thread, read_pct);
+        row.seqlock = benchmark_fresh<SeqlockHashMap>("Seqlock HashMap", threads,
+                                                      ops_per_thread, read_pct);
+        row.rcu = benchmark_fresh<RcuHashMap>("RCU HashMap (EBR)", threads,
+                                              ops_per_thread, read_pct);
+        rows.push_back(row);
+    }
+    
+    printf("\n=== ESCALAMIENTO DE LECTURAS (%d%% lecturas, Mops/seg y eficiencia) ===\n",
+           read_pct);
+    printf("%-7s %12s %7s %12s %7s %16s %7s %12s %7s %12s %7s\n", "Hilos", "RWLock", "Efic.",
+           "BRLock", "Efic.", "Striped rwlock", "Efic.", "Seqlock", "Efic.", "RCU (EBR)", "Efic.");
+    const Row& base = rows[0];
+    for (const Row& row : rows) {
+        printf("%-7d %12.3f %6.0f%% %12.3f %6.0f%% %16.3f %6.0f%% %12.3f %6.0f%% %12.3f %6.0f%%\n",
+               row.threads,
+               row.rwlock / 1e6, 100.0 * row.rwlock / (row.threads * base.rwlock),
+               row.brlock / 1e6, 100.0 * row.brlock / (row.threads * base.brlock),
+               row.striped / 1e6, 100.0 * row.striped / (row.threads * base.striped),
+               row.seqlock / 1e6, 100.0 * row.seqlock / (row.threads * base.seqlock),
+               row.rcu / 1e6, 100.0 * row.rcu / (row.threads * base.rcu));
+    }
+}
+
+/**
+ * Tabla resumen: una fila por proporción de lecturas, una columna por
+ * variante de hashmap (throughput en millones de ops/seg)
+ */
+struct SummaryTable {
+    std::vector<std::string> columns;
+    std::vector<int> rows;
+    std::vector<std::vector<double>> cells;  // cells[fila][columna], 0 = sin dato
+    
+    void add(int read_pct, const std::string& column, double throughput) {
+        std::size_t col = 0;
+        while (col < columns.size() && columns[col] != column) col++;
+        if (col == columns.size()) columns.push_back(column);
+        
+        std::size_t row = 0;
+        while (row < rows.size() && rows[row] != read_pct) row++;
+        if (row == rows.size()) {
+            rows.push_back(read_pct);
+            cells.emplace_back();
+        }
+        if (cells[row].size() <= col) cells[row].resize(col + 1, 0.0);
+        cells[row][col] = throughput;
+    }
+    
+    void print(const char* title) const {
+        printf("\n=== %s (Mops/seg) ===\n", title);
+        printf("%-6s", "R/W");
+        for (const std::string& column : columns) {
+            printf(" %16s", column.c_str());
+        }
+        printf("\n");
+        for (std::size_t row = 0; row < rows.size(); row++) {
+            char pct[16];
+            snprintf(pct, sizeof(pct), "%d/%d", rows[row], 100 - rows[row]);
+            printf("%-6s", pct);
+            for (std::size_t col = 0; col < columns.size(); col++) {
+                double value = col < cells[row].size() ? cells[row][col] : 0.0;
+                if (value > 0.0) {
+                    printf(" %16.3f", value / 1e6);
+                } else {
+                    printf(" %16s", "-");
+                }
+            }
+            printf("\n");
+        }
+    }
+};
+
+// ============================================================================
+// FUNCIÓN PRINCIPAL
+// ============================================================================
+
+int main(int argc, char** argv) {
+    printf("=== LABORATORIO 6 - PRÁCTICA 3: LECTORES/ESCRITORES ===\n");
+    
+    if (!extract_placement_arg(&argc, argv, &g_placement)) {
+        return 1;
+    }
+    g_pool.set_placement(&g_placement);
+    
+    // Opciones: --stripes N y --stripe-lock mutex,rwlock,spin (o all)
+    int num_stripes = DEFAULT_STRIPES;
+    const char* stripe_locks = "all";
+    long growth_keys = DEFAULT_GROWTH_KEYS;
+    const char* key_spec = "uniform";
+    const char* trace_in = nullptr;       // --trace: reproducir en vez de generar
+    const char* trace_out = nullptr;      // --trace-out: grabar la carga y salir
+    int trace_read_pct = 90;
+    std::vector<char*> positional = {argv[0]};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--stripes") == 0 && i + 1 < argc) {
+            num_stripes = std::atoi(argv[++i]);
+        } else if (strncmp(argv[i], "--stripes=", 10) == 0) {
+            num_stripes = std::atoi(argv[i] + 10);
+        } else if (strcmp(argv[i], "--stripe-lock") == 0 && i + 1 < argc) {
+            stripe_locks = argv[++i];
+        } else if (strncmp(argv[i], "--stripe-lock=", 14) == 0) {
+            stripe_locks = argv[i] + 14;
+        } else if (strcmp(argv[i], "--keys") == 0 && i + 1 < argc) {
+            key_spec = argv[++i];
+        } else if (strncmp(argv[i], "--keys=", 7) == 0) {
+            key_spec = argv[i] + 7;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_in = argv[++i];
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            trace_in = argv[i] + 8;
+        } else if (strcmp(argv[i], "--trace-out") == 0 && i + 1 < argc) {
+            trace_out = argv[++i];
+        } else if (strncmp(argv[i], "--trace-out=", 12) == 0) {
+            trace_out = argv[i] + 12;
+        } else if (strcmp(argv[i], "--trace-read-pct") == 0 && i + 1 < argc) {
+            trace_read_pct = std::atoi(argv[++i]);
+        } else if (strncmp(argv[i], "--trace-read-pct=", 17) == 0) {
+            trace_read_pct = std::atoi(argv[i] + 17);
+        } else if (strcmp(argv[i], "--sample-every") == 0 && i + 1 < argc) {
+            g_sample_every = std::atoi(argv[++i]);
+        } else if (strncmp(argv[i], "--sample-every=", 15) == 0) {
+            g_sample_every = std::atoi(argv[i] + 15);
+        } else if (strcmp(argv[i], "--growth-keys") == 0 && i + 1 < argc) {
+            growth_keys = std::atol(argv[++i]);
+        } else if (strncmp(argv[i], "--growth-keys=", 14) == 0) {
+            growth_keys = std::atol(argv[i] + 14);
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+    int npos = (int)positional.size();
+    
+    bool all_locks = strcmp(stripe_locks, "all") == 0;
+    bool striped_mutex = all_locks || strstr(stripe_locks, "mutex") != nullptr;
+    bool striped_rwlock = all_locks || strstr(stripe_locks, "rwlock") != nullptr;
+    bool striped_spin = all_locks || strstr(stripe_locks, "spin") != nullptr;
+    if (num_stripes < 1 || num_stripes > NUM_BUCKETS ||
+        !(striped_mutex || striped_rwlock || striped_spin)) {
+        fprintf(stderr, "Error: --stripes entre 1 y %d, --stripe-lock mutex,rwlock,spin o all\n",
+                NUM_BUCKETS);
+        return 1;
+    }
+    if (!g_key_dist.parse(key_spec)) {
+        fprintf(stderr, "Error: --keys uniform | zipf[:THETA] | hotset[:OPS%%:KEYS%%] | sequential\n");
+        return 1;
+    }
+    g_key_dist.prepare(KEY_RANGE);
+    if (growth_keys < 0 || growth_keys > INT32_MAX) {
+        fprintf(stderr, "Error: --growth-keys entre 0 (omitir) y %d\n", INT32_MAX);
+        return 1;
+    }
+    if (g_sample_every < 0) {
+        fprintf(stderr, "Error: --sample-every >= 0 (0 = sin muestreo de latencia)\n");
+        return 1;
+    }
+    if (trace_read_pct < 0 || trace_read_pct > 100 || (trace_in && trace_out)) {
+        fprintf(stderr, "Error: --trace-read-pct entre 0 y 100; --trace y --trace-out no se combinan\n");
+        return 1;
+    }
+    
+    // Parámetros configurables
+    int num_threads = (npos > 1) ? std::atoi(positional[1]) : 4;
+    long ops_per_thread = (npos > 2) ? std::atol(positional[2]) : 100000;
+    if (num_threads < 1 || num_threads >= MAX_THREAD_INDEX) {
+        fprintf(stderr, "Error: hilos entre 1 y %d (índices por hilo)\n", MAX_THREAD_INDEX - 1);
+        return 1;
+    }
+    
+    printf("Configuración: %d hilos, %ld ops/hilo\n", num_threads, ops_per_thread);
+    printf("Buckets: %d, Rango de claves: %d\n", NUM_BUCKETS, KEY_RANGE);
+    printf("Franjas (StripedHashMap): %d, locks: %s\n", num_stripes, stripe_locks);
+    printf("Claves: %s, la más popular recibe %.2f%% de los accesos\n",
+           g_key_dist.describe().c_str(), 100.0 * g_key_dist.top_key_share());
+    printf("Escenario de crecimiento: %ld claves\n", growth_keys);
+    if (g_sample_every > 0) {
+        printf("Latencia: 1 de cada %d ops medida con %s (%.3f ciclos/ns)\n", g_sample_every,
+#if defined(__x86_64__) || defined(__i386__)
+               "rdtsc",
+#else
+               "CLOCK_MONOTONIC",
+#endif
+               cycles_per_ns());
+    } else {
+        printf("Latencia: sin muestreo\n");
+    }
+    printf("Afinidad: %s\n", g_placement.describe().c_str());
+    
+    // Grabar la carga sintética actual (hilos, ops, --keys) como traza
+    if (trace_out) {
+        std::vector<std::vector<WorkloadOp>> workloads(num_threads);
+        for (int i = 0; i < num_threads; i++) {
+            workloads[i] = g_key_dist.generate(ops_per_thread, trace_read_pct, 0,
+                                               i, num_threads, 42 + i);
+        }
+        std::string error;
+        if (!OpTrace::write(trace_out, workloads, &error)) {
+            fprintf(stderr, "Error: traza %s: %s\n", trace_out, error.c_str());
+            return 1;
+        }
+        printf("✅ Traza escrita en %s: %d hilos x %ld ops (%d%% lecturas)\n",
+               trace_out, num_threads, ops_per_thread, trace_read_pct);
+        return 0;
+    }
+    
+    // Reproducir una traza (sintética o capturada) en todas las variantes
+    if (trace_in) {
+        OpTrace trace;
+        std::string error;
+        if (!trace.load(trace_in, &error)) {
+            fprintf(stderr, "Error: traza %s: %s\n", trace_in, error.c_str());
+            return 1;
+        }
+        if (trace.num_threads() >= MAX_THREAD_INDEX) {
+            fprintf(stderr, "Error: la traza tiene %d hilos (máximo %d)\n",
+                    trace.num_threads(), MAX_THREAD_INDEX - 1);
+            return 1;
+        }
+        printf("Traza %s: %d hilos, %ld ops (los argumentos de hilos/ops se ignoran)\n",
+               trace_in, trace.num_threads(), trace.total_ops());
+        run_trace_replay(trace, num_stripes, striped_mutex, striped_rwlock, striped_spin);
+        return 0;
+    }
+    
+    SummaryTable summary;
+    
+    // Diferentes proporciones de lectura/escritura para probar
+    std::vector<int> read_percentages = {90, 70, 50, 30, 10};
+    
+    printf("\n=== COMPARACIÓN MUTEX vs RWLOCK ===\n");
+    
+        for (int read_pct : read_percentages) {
+        printf("\n============================================================\n");
+        printf("PROPORCIÓN: %d%% LECTURAS, %d%% ESCRITURAS\n", read_pct, 100 - read_pct);
+        printf("============================================================\n");
+        
+        // Test con Mutex HashMap
+        MutexHashMap<> mutex_map;
+        populate_hashmap(&mutex_map, INITIAL_ENTRIES);
+        double mutex_throughput = benchmark_hashmap("Mutex HashMap", &mutex_map,
                                                     num_threads, ops_per_thread, read_pct);
         
+        // Test con RWLock HashMap  
+        RWLockHashMap<> rwlock_map;
+        populate_hashmap(&rwlock_map, INITIAL_ENTRIES);
+        double rwlock_throughput = benchmark_hashmap("RWLock HashMap", &rwlock_map,
+                                                     num_threads, ops_per_thread, read_pct);
+        
         // Análisis comparativo
         double speedup = rwlock_throughput / mutex_throughput;
         printf("\n--- ANÁLISIS ---\n");
@@ -474,8 +2367,82 @@ int main(int argc, char** argv) {
         } else {
             printf("⚖️  Rendimiento similar (diferencia < 10%%)\n");
         }
+        summary.add(read_pct, "Mutex", mutex_throughput);
+        summary.add(read_pct, "RWLock", rwlock_throughput);
+        
+        // Lectores distribuidos: sin línea compartida en las lecturas
+        double brlock_throughput = benchmark_fresh<BrlockHashMap>(
+            "BRLock HashMap", num_threads, ops_per_thread, read_pct);
+        printf("Speedup BRLock vs RWLock: %.2fx\n", brlock_throughput / rwlock_throughput);
+        summary.add(read_pct, "BRLock", brlock_throughput);
+        
+        // Lock striping: un lock por rango de buckets
+        if (striped_mutex) {
+            double t = benchmark_striped<StripeMutex>(num_stripes, num_threads,
+                                                      ops_per_thread, read_pct);
+            printf("Speedup Striped(mutex) vs Mutex: %.2fx\n", t / mutex_throughput);
+            summary.add(read_pct, "Striped mutex", t);
+        }
+        if (striped_rwlock) {
+            double t = benchmark_striped<StripeRWLock>(num_stripes, num_threads,
+                                                       ops_per_thread, read_pct);
+            printf("Speedup Striped(rwlock) vs Mutex: %.2fx\n", t / mutex_throughput);
+            summary.add(read_pct, "Striped rwlock", t);
+        }
+        if (striped_spin) {
+            double t = benchmark_striped<StripeSpinLock>(num_stripes, num_threads,
+                                                         ops_per_thread, read_pct);
+            printf("Speedup Striped(spinlock) vs Mutex: %.2fx\n", t / mutex_throughput);
+            summary.add(read_pct, "Striped spin", t);
+        }
+        
+        // Seqlock por bucket: lecturas optimistas sin escribir memoria compartida
+        double seqlock_throughput = benchmark_fresh<SeqlockHashMap>(
+            "Seqlock HashMap", num_threads, ops_per_thread, read_pct);
+        printf("Speedup Seqlock vs Mutex: %.2fx\n", seqlock_throughput / mutex_throughput);
+        summary.add(read_pct, "Seqlock", seqlock_throughput);
+        
+        // RCU/EBR: lectores wait-free, liberación diferida
+        double rcu_throughput = benchmark_fresh<RcuHashMap>(
+            "RCU HashMap (EBR)", num_threads, ops_per_thread, read_pct);
+        printf("Speedup RCU vs Mutex: %.2fx\n", rcu_throughput / mutex_throughput);
+        summary.add(read_pct, "RCU (EBR)", rcu_throughput);
+        
+        // Tabla plana con los mismos locks: global y por franjas
+        double flat_mutex = benchmark_flat<StripeMutex>(1, num_threads, ops_per_thread, read_pct);
+        printf("Speedup Flat(mutex) vs Mutex: %.2fx\n", flat_mutex / mutex_throughput);
+        summary.add(read_pct, "Flat mutex", flat_mutex);
+        double flat_rwlock = benchmark_flat<StripeRWLock>(1, num_threads, ops_per_thread, read_pct);
+        printf("Speedup Flat(rwlock) vs RWLock: %.2fx\n", flat_rwlock / rwlock_throughput);
+        summary.add(read_pct, "Flat rwlock", flat_rwlock);
+        if (striped_spin) {
+            double t = benchmark_flat<StripeSpinLock>(num_stripes, num_threads,
+                                                      ops_per_thread, read_pct);
+            printf("Speedup Flat striped(spinlock) vs Mutex: %.2fx\n", t / mutex_throughput);
+            summary.add(read_pct, "Flat stripe spin", t);
+        }
+    }
+    
+    summary.print("RESUMEN DE THROUGHPUT");
+    
+    // Mismas búsquedas en un hilo: costo de perseguir nodos vs sondeo plano
+    run_lookup_latency(std::max(ops_per_thread * 10, 1000000L));
+    
+    // Cargas de escritura: malloc dentro vs fuera del lock global
+    run_allocator_comparison(num_threads, ops_per_thread);
+    run_rwlock_comparison(num_threads, ops_per_thread, 90);
+    
+    // Rango de claves grande: la tabla crece mientras se mide la cola
+    if (growth_keys > 0) {
+        run_growth_scenario(num_threads, growth_keys);
     }
     
+    // Carga casi solo de lectura: ¿escalan las lecturas con los núcleos?
+    // (hasta todos los hilos de hardware, dentro del límite de índices por hilo)
+    int hw_threads = (int)std::thread::hardware_concurrency();
+    run_read_scaling(std::min(std::max(num_threads, hw_threads), MAX_THREAD_INDEX - 1),
+                     ops_per_thread, 99);
+    
     printf("\n============================================================\n");
     printf("=== CONCLUSIONES ===\n");
     printf("• RWLock conviene cuando > 70%% son lecturas\n");
@@ -483,6 +2450,20 @@ int main(int argc, char** argv) {
     printf("• El tamaño del bucket afecta la contención:\n");
     printf("  - Más buckets = menos colisiones = menos contención\n");
     printf("  - Menos buckets = más colisiones = más contención\n");
+    printf("• Lock striping: con N franjas dos operaciones chocan ~1/N de las veces;\n");
+    printf("  un lock global serializa todo sin importar cuántos hilos haya\n");
+    printf("• Seqlock: get() solo lee (la línea del bucket queda compartida en todas\n");
+    printf("  las cachés); un rwlock escribe su contador en cada lectura y la línea rebota\n");
+    printf("• BRLock: cada lector marca solo su propio slot y no comparte líneas;\n");
+    printf("  el escritor recorre un slot por hilo, así que las escrituras encarecen\n");
+    printf("• RCU/EBR: el lector solo publica su época en su propio slot; el costo se\n");
+    printf("  traslada a memoria retenida (nodos retirados esperando el periodo de gracia)\n");
+    printf("• Tabla plana: claves contiguas y 16 bytes de control comparados con una\n");
+    printf("  instrucción SSE2; una búsqueda toca ~3 líneas en vez de una por nodo\n");
+    printf("• Pool de nodos: sin malloc/free con el lock tomado la sección crítica de\n");
+    printf("  put() se acorta y el lock global se libera antes para el siguiente escritor\n");
+    printf("• Rehash incremental: cada escritura mueve unos pocos buckets; el rehash\n");
+    printf("  completo hace que un put() pague la copia de toda la tabla (cola larga)\n");
     
     printf("\n=== PREGUNTAS GUÍA RESPONDIDAS ===\n");
     printf("• ¿Cuándo conviene rwlock? → Cuando hay mayoría de lecturas (> 70%%)\n");
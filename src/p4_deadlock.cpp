@@ -13,11 +13,12 @@
 #include <unistd.h>
 #include <cstdio>
 #include <cstdlib>
-#include <chrono>
 #include <vector>
 #include <cassert>
 #include <random>
 #include <algorithm>
+#include "thread_affinity.hpp"
+#include "thread_pool.hpp"
 
 // ============================================================================
 // RECURSOS COMPARTIDOS Y SINCRONIZACIÓN
@@ -26,6 +27,12 @@
 pthread_mutex_t mutex_A = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t mutex_B = PTHREAD_MUTEX_INITIALIZER;
 
+// Colocación de hilos seleccionada con --placement (por defecto: sin afinidad)
+static ThreadPlacement g_placement;
+
+// Hilos persistentes: crear/join hilos queda fuera de la región medida
+static ThreadPool g_pool;
+
 // Variables compartidas protegidas por los mutex
 int shared_resource_A = 0;
 int shared_resource_B = 0;
@@ -314,24 +321,16 @@ void demonstrate_deadlock() {
     shared_resource_A = 0;
     shared_resource_B = 0;
     
-    pthread_t thread1, thread2;
     int id1 = 1, id2 = 2;
     
-    auto start = std::chrono::steady_clock::now();
-    
-    // Crear hilos con orden opuesto de adquisición de mutex
-    pthread_create(&thread1, nullptr, thread_deadlock_1, &id1);
-    pthread_create(&thread2, nullptr, thread_deadlock_2, &id2);
+    // Lanzar hilos con orden opuesto de adquisición de mutex
+    g_pool.launch({{thread_deadlock_1, &id1, 0}, {thread_deadlock_2, &id2, 0}});
     
     // Intentar join con timeout simulado
     printf("Esperando terminación de hilos...\n");
     
     // En un sistema real, usaríamos pthread_timedjoin_np o señales para timeout
-    pthread_join(thread1, nullptr);
-    pthread_join(thread2, nullptr);
-    
-    auto end = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration<double>(end - start).count();
+    double duration = g_pool.wait();
     
     printf("✅ Hilos terminaron en %.2f segundos\n", duration);
     printf("Valores finales: A=%d, B=%d\n", shared_resource_A, shared_resource_B);
@@ -352,22 +351,15 @@ void benchmark_ordered_solution(int num_threads) {
     shared_resource_A = 0;
     shared_resource_B = 0;
     
-    std::vector<pthread_t> threads(num_threads);
+    std::vector<PoolTask> tasks(num_threads);
     std::vector<int> thread_ids(num_threads);
     
-    auto start = std::chrono::steady_clock::now();
-    
     for (int i = 0; i < num_threads; i++) {
         thread_ids[i] = i + 1;
-        pthread_create(&threads[i], nullptr, thread_ordered_lock, &thread_ids[i]);
-    }
-    
-    for (int i = 0; i < num_threads; i++) {
-        pthread_join(threads[i], nullptr);
+        tasks[i] = {thread_ordered_lock, &thread_ids[i], 0};
     }
     
-    auto end = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration<double>(end - start).count();
+    double duration = g_pool.run(tasks);
     
     printf("⏱️  Tiempo total: %.3f segundos\n", duration);
     printf("📊 Valores finales: A=%d, B=%d\n", shared_resource_A, shared_resource_B);
@@ -385,22 +377,15 @@ void benchmark_trylock_solution(int num_threads) {
     shared_resource_A = 0;
     shared_resource_B = 0;
     
-    std::vector<pthread_t> threads(num_threads);
+    std::vector<PoolTask> tasks(num_threads);
     std::vector<int> thread_ids(num_threads);
     
-    auto start = std::chrono::steady_clock::now();
-    
     for (int i = 0; i < num_threads; i++) {
         thread_ids[i] = i + 1;
-        pthread_create(&threads[i], nullptr, thread_trylock_backoff, &thread_ids[i]);
+        tasks[i] = {thread_trylock_backoff, &thread_ids[i], 0};
     }
     
-    for (int i = 0; i < num_threads; i++) {
-        pthread_join(threads[i], nullptr);
-    }
-    
-    auto end = std::chrono::steady_clock::now();
-    auto duration = std::chrono::duration<double>(end - start).count();
+    double duration = g_pool.run(tasks);
     
     printf("⏱️  Tiempo total: %.3f segundos\n", duration);
     printf("📊 Valores finales: A=%d, B=%d\n", shared_resource_A, shared_resource_B);
@@ -414,10 +399,16 @@ void benchmark_trylock_solution(int num_threads) {
 int main(int argc, char** argv) {
     printf("=== LABORATORIO 6 - PRÁCTICA 4: DEADLOCK ===\n");
     
+    if (!extract_placement_arg(&argc, argv, &g_placement)) {
+        return 1;
+    }
+    g_pool.set_placement(&g_placement);
+    
     int num_threads = (argc > 1) ? std::atoi(argv[1]) : 4;
     bool skip_deadlock_demo = (argc > 2) && (std::atoi(argv[2]) == 1);
     
     printf("Configuración: %d hilos\n", num_threads);
+    printf("Afinidad: %s\n", g_placement.describe().c_str());
     
     // Demostración de deadlock (opcional)
     if (!skip_deadlock_demo) {
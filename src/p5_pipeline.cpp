@@ -14,20 +14,23 @@
 #include <cstdlib>
 #include <chrono>
 #include <vector>
-#include <queue>
 #include <fstream>
 #include <cassert>
 #include <unistd.h>
 #include <random>
 #include <cstring>
 #include <cmath>  
+#include "ring.hpp"
+#include "thread_affinity.hpp"
+#include "thread_pool.hpp"
 
 // ============================================================================
 // CONSTANTES Y CONFIGURACIÓN DEL PIPELINE
 // ============================================================================
 
 constexpr int DEFAULT_TICKS = 1000;        // Número de iteraciones del pipeline
-constexpr int BUFFER_SIZE = 100;           // Tamaño de búfers entre etapas
+constexpr int BUFFER_SIZE = 100;           // Tamaño de búfers entre etapas (se redondea a 128)
+constexpr uint64_t BUFFER_TIMEOUT_NS = 1000ull * 1000000;  // Espera máxima en un búfer (1 s)
 constexpr int DATA_RANGE = 10000;          // Rango de datos a procesar
 
 // Tipos de datos que fluyen por el pipeline
@@ -53,21 +56,21 @@ static pthread_barrier_t pipeline_barrier;
 // pthread_once para inicialización única
 static pthread_once_t once_flag = PTHREAD_ONCE_INIT;
 
-// Búfers entre etapas (protegidos por mutex)
-static std::queue<DataItem> stage1_to_stage2;
-static std::queue<DataItem> stage2_to_stage3;
-static pthread_mutex_t buffer1_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t buffer2_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Colocación de hilos seleccionada con --placement (por defecto: sin afinidad)
+// Cada etapa es un grupo distinto: cross-socket separa generador y procesador
+static ThreadPlacement g_placement;
 
-// Condición para señalizar datos disponibles/espacio disponible
-static pthread_cond_t buffer1_not_empty = PTHREAD_COND_INITIALIZER;
-static pthread_cond_t buffer1_not_full = PTHREAD_COND_INITIALIZER;
-static pthread_cond_t buffer2_not_empty = PTHREAD_COND_INITIALIZER;
-static pthread_cond_t buffer2_not_full = PTHREAD_COND_INITIALIZER;
+// Hilos persistentes: crear/join hilos queda fuera de la región medida
+static ThreadPool g_pool;
 
-// Control de terminación del pipeline
-static bool pipeline_shutdown = false;
-static pthread_mutex_t shutdown_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Búfers entre etapas: anillos SPSC (cada uno tiene una sola etapa que
+// escribe y una sola que lee). Los DataItem se construyen y se leen dentro
+// del slot; close() hace el shutdown sin perder lo pendiente.
+// Como con las condvars not_empty/not_full de antes, una etapa sin datos
+// bloquea hasta que la anterior publica y una con el búfer lleno hasta que
+// la siguiente libera un slot (el anillo avisa en ambos sentidos)
+static Ring<DataItem> stage1_to_stage2;
+static Ring<DataItem> stage2_to_stage3;
 
 // Recursos compartidos globales (inicializados una sola vez)
 static std::ofstream* log_file = nullptr;
@@ -148,40 +151,17 @@ static void init_shared_resources() {
 // ============================================================================
 
 /**
- * Insertar item en búfer entre etapas 1 y 2
+ * Construir un item directamente en el búfer entre etapas 1 y 2
+ * @return: false si venció el plazo o el pipeline se cerró
  */
-bool push_to_buffer1(const DataItem& item, int timeout_ms = 1000) {
-    struct timespec abs_timeout;
-    clock_gettime(CLOCK_REALTIME, &abs_timeout);
-    abs_timeout.tv_sec += timeout_ms / 1000;
-    abs_timeout.tv_nsec += (timeout_ms % 1000) * 1000000;
-    if (abs_timeout.tv_nsec >= 1000000000) {
-        abs_timeout.tv_sec++;
-        abs_timeout.tv_nsec -= 1000000000;
-    }
-    
-    pthread_mutex_lock(&buffer1_mutex);
-    
-    // Esperar espacio disponible
-    while (stage1_to_stage2.size() >= BUFFER_SIZE && !pipeline_shutdown) {
-        if (pthread_cond_timedwait(&buffer1_not_full, &buffer1_mutex, &abs_timeout) != 0) {
-            pthread_mutex_unlock(&buffer1_mutex);
-            return false;  // Timeout
-        }
-    }
-    
-    if (pipeline_shutdown) {
-        pthread_mutex_unlock(&buffer1_mutex);
-        return false;
-    }
+bool emplace_to_buffer1(int id, int raw_value, uint64_t timeout_ns = BUFFER_TIMEOUT_NS) {
+    DataItem* item = stage1_to_stage2.claim_for(timeout_ns, id, raw_value);
+    if (!item) return false;
+    stage1_to_stage2.commit();
     
-    stage1_to_stage2.push(item);
-    pthread_cond_signal(&buffer1_not_empty);
-    pthread_mutex_unlock(&buffer1_mutex);
-    
-    // Log de la operación
+    // Log de la operación (con los argumentos: el slot ya es del consumidor)
     if (log_file && log_file->is_open()) {
-        *log_file << "Stage1," << item.id << "," << item.raw_value << "," 
+        *log_file << "Stage1," << id << "," << raw_value << "," 
                   << std::chrono::duration_cast<std::chrono::milliseconds>(
                        std::chrono::steady_clock::now().time_since_epoch()).count() 
                   << std::endl;
@@ -191,73 +171,17 @@ bool push_to_buffer1(const DataItem& item, int timeout_ms = 1000) {
 }
 
 /**
- * Extraer item del búfer entre etapas 1 y 2
- */
-bool pop_from_buffer1(DataItem& item, int timeout_ms = 1000) {
-    struct timespec abs_timeout;
-    clock_gettime(CLOCK_REALTIME, &abs_timeout);
-    abs_timeout.tv_sec += timeout_ms / 1000;
-    abs_timeout.tv_nsec += (timeout_ms % 1000) * 1000000;
-    if (abs_timeout.tv_nsec >= 1000000000) {
-        abs_timeout.tv_sec++;
-        abs_timeout.tv_nsec -= 1000000000;
-    }
-    
-    pthread_mutex_lock(&buffer1_mutex);
-    
-    while (stage1_to_stage2.empty() && !pipeline_shutdown) {
-        if (pthread_cond_timedwait(&buffer1_not_empty, &buffer1_mutex, &abs_timeout) != 0) {
-            pthread_mutex_unlock(&buffer1_mutex);
-            return false;  // Timeout
-        }
-    }
-    
-    if (stage1_to_stage2.empty()) {
-        pthread_mutex_unlock(&buffer1_mutex);
-        return false;
-    }
-    
-    item = stage1_to_stage2.front();
-    stage1_to_stage2.pop();
-    pthread_cond_signal(&buffer1_not_full);
-    pthread_mutex_unlock(&buffer1_mutex);
-    
-    return true;
-}
-
-/**
- * Insertar item en búfer entre etapas 2 y 3
+ * Mover un item (ya procesado en el slot del búfer 1) al búfer entre
+ * etapas 2 y 3
  */
-bool push_to_buffer2(const DataItem& item, int timeout_ms = 1000) {
-    struct timespec abs_timeout;
-    clock_gettime(CLOCK_REALTIME, &abs_timeout);
-    abs_timeout.tv_sec += timeout_ms / 1000;
-    abs_timeout.tv_nsec += (timeout_ms % 1000) * 1000000;
-    if (abs_timeout.tv_nsec >= 1000000000) {
-        abs_timeout.tv_sec++;
-        abs_timeout.tv_nsec -= 1000000000;
-    }
-    
-    pthread_mutex_lock(&buffer2_mutex);
-    
-    while (stage2_to_stage3.size() >= BUFFER_SIZE && !pipeline_shutdown) {
-        if (pthread_cond_timedwait(&buffer2_not_full, &buffer2_mutex, &abs_timeout) != 0) {
-            pthread_mutex_unlock(&buffer2_mutex);
-            return false;  // Timeout
-        }
-    }
-    
-    if (pipeline_shutdown) {
-        pthread_mutex_unlock(&buffer2_mutex);
-        return false;
-    }
-    
-    stage2_to_stage3.push(item);
-    pthread_cond_signal(&buffer2_not_empty);
-    pthread_mutex_unlock(&buffer2_mutex);
+bool push_to_buffer2(DataItem&& item, uint64_t timeout_ns = BUFFER_TIMEOUT_NS) {
+    int id = item.id;
+    double processed_value = item.processed_value;
+    if (!stage2_to_stage3.claim_for(timeout_ns, std::move(item))) return false;
+    stage2_to_stage3.commit();
     
     if (log_file && log_file->is_open()) {
-        *log_file << "Stage2," << item.id << "," << item.processed_value << "," 
+        *log_file << "Stage2," << id << "," << processed_value << "," 
                   << std::chrono::duration_cast<std::chrono::milliseconds>(
                        std::chrono::steady_clock::now().time_since_epoch()).count() 
                   << std::endl;
@@ -266,41 +190,6 @@ bool push_to_buffer2(const DataItem& item, int timeout_ms = 1000) {
     return true;
 }
 
-/**
- * Extraer item del búfer entre etapas 2 y 3
- */
-bool pop_from_buffer2(DataItem& item, int timeout_ms = 1000) {
-    struct timespec abs_timeout;
-    clock_gettime(CLOCK_REALTIME, &abs_timeout);
-    abs_timeout.tv_sec += timeout_ms / 1000;
-    abs_timeout.tv_nsec += (timeout_ms % 1000) * 1000000;
-    if (abs_timeout.tv_nsec >= 1000000000) {
-        abs_timeout.tv_sec++;
-        abs_timeout.tv_nsec -= 1000000000;
-    }
-    
-    pthread_mutex_lock(&buffer2_mutex);
-    
-    while (stage2_to_stage3.empty() && !pipeline_shutdown) {
-        if (pthread_cond_timedwait(&buffer2_not_empty, &buffer2_mutex, &abs_timeout) != 0) {
-            pthread_mutex_unlock(&buffer2_mutex);
-            return false;  // Timeout
-        }
-    }
-    
-    if (stage2_to_stage3.empty()) {
-        pthread_mutex_unlock(&buffer2_mutex);
-        return false;
-    }
-    
-    item = stage2_to_stage3.front();
-    stage2_to_stage3.pop();
-    pthread_cond_signal(&buffer2_not_full);
-    pthread_mutex_unlock(&buffer2_mutex);
-    
-    return true;
-}
-
 // ============================================================================
 // ETAPAS DEL PIPELINE
 // ============================================================================
@@ -308,6 +197,7 @@ bool pop_from_buffer2(DataItem& item, int timeout_ms = 1000) {
 /**
  * ETAPA 1: GENERADOR
  * Genera datos de entrada para el pipeline
+ * Con el búfer 1 lleno bloquea hasta que la etapa 2 libere un slot
  */
 void* stage_generator(void* arg) {
     long stage_id = reinterpret_cast<long>(arg);
@@ -323,10 +213,9 @@ void* stage_generator(void* arg) {
     for (int tick = 0; tick < ticks; tick++) {
         // Generar nuevo item de datos
         int raw_value = value_dist(*global_rng);
-        DataItem item(tick, raw_value);
         
-        // Intentar insertar en búfer hacia etapa 2
-        if (!push_to_buffer1(item)) {
+        // Construir el item directamente en el búfer hacia etapa 2
+        if (!emplace_to_buffer1(tick, raw_value)) {
             printf("[Etapa %ld] Timeout/Error enviando item %d\n", stage_id, tick);
             break;
         }
@@ -362,6 +251,8 @@ void* stage_generator(void* arg) {
 /**
  * ETAPA 2: PROCESADOR
  * Aplica transformaciones complejas a los datos
+ * Sin datos bloquea hasta que la etapa 1 publique; con el búfer 2 lleno,
+ * hasta que la etapa 3 libere un slot
  */
 void* stage_processor(void* arg) {
     long stage_id = reinterpret_cast<long>(arg);
@@ -373,13 +264,13 @@ void* stage_processor(void* arg) {
     pthread_once(&once_flag, init_shared_resources);
     
     for (int tick = 0; tick < DEFAULT_TICKS; tick++) {
-        DataItem item;
-        
-        // Obtener item del búfer de entrada
-        if (!pop_from_buffer1(item)) {
+        // Obtener item del búfer de entrada (se procesa dentro del slot)
+        DataItem* slot = stage1_to_stage2.front_for(BUFFER_TIMEOUT_NS);
+        if (!slot) {
             printf("[Etapa %ld] Timeout obteniendo item en tick %d\n", stage_id, tick);
             break;
         }
+        DataItem& item = *slot;
         
         // PROCESAMIENTO INTENSIVO:
         // 1. Aplicar función compleja usando tabla de lookup
@@ -401,9 +292,12 @@ void* stage_processor(void* arg) {
         
         processed_count++;
         
-        // Enviar a la siguiente etapa
-        if (!push_to_buffer2(item)) {
-            printf("[Etapa %ld] Error enviando item procesado %d\n", stage_id, item.id);
+        // Enviar a la siguiente etapa y devolver el slot de entrada
+        int item_id = item.id;
+        bool sent = push_to_buffer2(std::move(item));
+        stage1_to_stage2.release();
+        if (!sent) {
+            printf("[Etapa %ld] Error enviando item procesado %d\n", stage_id, item_id);
             break;
         }
         
@@ -432,6 +326,7 @@ void* stage_processor(void* arg) {
 /**
  * ETAPA 3: FILTRO Y REDUCTOR
  * Filtra datos válidos y los agrega a resultado final
+ * Sin datos bloquea hasta que la etapa 2 publique
  */
 void* stage_filter_reduce(void* arg) {
     long stage_id = reinterpret_cast<long>(arg);
@@ -444,13 +339,13 @@ void* stage_filter_reduce(void* arg) {
     pthread_once(&once_flag, init_shared_resources);
     
     for (int tick = 0; tick < DEFAULT_TICKS; tick++) {
-        DataItem item;
-        
-        // Obtener item del búfer de entrada
-        if (!pop_from_buffer2(item)) {
+        // Obtener item del búfer de entrada (se lee dentro del slot)
+        DataItem* slot = stage2_to_stage3.front_for(BUFFER_TIMEOUT_NS);
+        if (!slot) {
             printf("[Etapa %ld] Timeout obteniendo item en tick %d\n", stage_id, tick);
             break;
         }
+        DataItem& item = *slot;
         
         // FILTRADO: Solo aceptar items que cumplan criterios
         bool passes_filter = false;
@@ -497,6 +392,7 @@ void* stage_filter_reduce(void* arg) {
             pipeline_stats.items_filtered++;
             pthread_mutex_unlock(&pipeline_stats.stats_mutex);
         }
+        stage2_to_stage3.release();
         
         if ((tick + 1) % 100 == 0) {
             printf("[Etapa %ld] Procesados %d items, %d válidos (%.1f%%), suma=%.2f\n", 
@@ -524,15 +420,10 @@ void* stage_filter_reduce(void* arg) {
 // ============================================================================
 
 void request_pipeline_shutdown() {
-    pthread_mutex_lock(&shutdown_mutex);
-    pipeline_shutdown = true;
-    pthread_mutex_unlock(&shutdown_mutex);
-    
-    // Despertar todos los hilos esperando en condiciones
-    pthread_cond_broadcast(&buffer1_not_empty);
-    pthread_cond_broadcast(&buffer1_not_full);
-    pthread_cond_broadcast(&buffer2_not_empty);
-    pthread_cond_broadcast(&buffer2_not_full);
+    // Los productores dejan de insertar; los consumidores drenan lo pendiente
+    // y luego ven la cola cerrada (quien espera lo nota en su siguiente sondeo)
+    stage1_to_stage2.close();
+    stage2_to_stage3.close();
     
     printf("🛑 Shutdown del pipeline solicitado\n");
 }
@@ -550,34 +441,27 @@ void run_pipeline_benchmark(int num_ticks) {
     // Reinicializar barrier para 3 etapas
     pthread_barrier_init(&pipeline_barrier, nullptr, 3);
     
-    // Reset de variables globales
-    pipeline_shutdown = false;
+    // Reset de variables globales (init vacía y reabre los búfers)
     pipeline_stats = PipelineStats{};
+    if (!stage1_to_stage2.init(BUFFER_SIZE) || !stage2_to_stage3.init(BUFFER_SIZE)) {
+        printf("❌ Sin memoria para los búfers entre etapas\n");
+        pthread_barrier_destroy(&pipeline_barrier);
+        return;
+    }
     
-    // Crear hilos para cada etapa del pipeline
-    pthread_t generator_thread, processor_thread, filter_thread;
-    
-    auto start_time = std::chrono::steady_clock::now();
-    
-    // Crear etapas del pipeline
-    pthread_create(&generator_thread, nullptr, stage_generator, reinterpret_cast<void*>(1));
-    pthread_create(&processor_thread, nullptr, stage_processor, reinterpret_cast<void*>(2));
-    pthread_create(&filter_thread, nullptr, stage_filter_reduce, reinterpret_cast<void*>(3));
+    // Una tarea del pool por etapa del pipeline
+    std::vector<PoolTask> stages = {
+        {stage_generator,     reinterpret_cast<void*>(1), 0},
+        {stage_processor,     reinterpret_cast<void*>(2), 1},
+        {stage_filter_reduce, reinterpret_cast<void*>(3), 1},
+    };
     
+    g_pool.launch(stages);
     printf("🚀 Pipeline iniciado con 3 etapas\n");
     
     // Esperar terminación de todas las etapas
-    pthread_join(generator_thread, nullptr);
-    printf("✅ Etapa generadora terminada\n");
-    
-    pthread_join(processor_thread, nullptr);
-    printf("✅ Etapa procesadora terminada\n");
-    
-    pthread_join(filter_thread, nullptr);
-    printf("✅ Etapa filtro/reduce terminada\n");
-    
-    auto end_time = std::chrono::steady_clock::now();
-    auto total_duration = std::chrono::duration<double>(end_time - start_time).count();
+    double total_duration = g_pool.wait();
+    printf("✅ Etapas generadora, procesadora y filtro/reduce terminadas\n");
     
     printf("\n⏱️  RESULTADOS DEL BENCHMARK\n");
     printf("Tiempo total de ejecución: %.3f segundos\n", total_duration);
@@ -606,8 +490,14 @@ void run_pipeline_benchmark(int num_ticks) {
 int main(int argc, char** argv) {
     printf("=== LABORATORIO 6 - PRÁCTICA 5: PIPELINE CON BARRERAS ===\n");
     
+    if (!extract_placement_arg(&argc, argv, &g_placement)) {
+        return 1;
+    }
+    g_pool.set_placement(&g_placement);
+    
     int num_ticks = (argc > 1) ? std::atoi(argv[1]) : DEFAULT_TICKS;
     printf("Configuración: %d ticks por etapa\n", num_ticks);
+    printf("Afinidad: %s\n", g_placement.describe().c_str());
     
     // Crear directorio de datos si no existe
     system("mkdir -p data");
@@ -638,8 +528,8 @@ int main(int argc, char** argv) {
     printf("• Muestreo periódico para detectar cuellos de botella\n\n");
     
     printf("🛑 GRACEFUL SHUTDOWN:\n");
-    printf("• Bandera global de shutdown\n");
-    printf("• Broadcast a todas las condition variables\n");
+    printf("• close() en cada búfer: insertar falla, extraer drena lo pendiente\n");
+    printf("• Las esperas sondean el cierre (sin condition variables que despertar)\n");
     printf("• Timeout en operaciones de buffer\n");
     printf("• Join de todos los hilos antes de limpiar recursos\n\n");
     
@@ -654,7 +544,7 @@ int main(int argc, char** argv) {
     printf("• ¿Cómo medir throughput por etapa?\n");
     printf("  → Timestamps + contadores atómicos + sampling periódico\n");
     printf("• ¿Cómo graceful shutdown sin deadlocks?\n");
-    printf("  → Bandera global + timeouts + broadcast + join ordenado\n");
+    printf("  → Cerrar búfers + timeouts + join ordenado\n");
     
     // Cleanup de recursos globales
     if (log_file) {
@@ -669,14 +559,7 @@ int main(int argc, char** argv) {
     }
     
     // Cleanup de primitivas de sincronización
-    pthread_mutex_destroy(&buffer1_mutex);
-    pthread_mutex_destroy(&buffer2_mutex);
-    pthread_mutex_destroy(&shutdown_mutex);
     pthread_mutex_destroy(&pipeline_stats.stats_mutex);
-    pthread_cond_destroy(&buffer1_not_empty);
-    pthread_cond_destroy(&buffer1_not_full);
-    pthread_cond_destroy(&buffer2_not_empty);
-    pthread_cond_destroy(&buffer2_not_full);
     
     printf("\n✅ Programa terminado exitosamente\n");
     printf("📄 Log generado en: data/pipeline_log.txt\n");